@@ -0,0 +1,127 @@
+#!/usr/bin/env ruby
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+# A self-contained benchmark suite. It doesn't need any external
+# data: documents are generated from a seed.
+#
+# Run the suite and save the result as JSON:
+#   % ruby benchmark/suite.rb run --output base.json
+#
+# Run only matched cases:
+#   % ruby benchmark/suite.rb run --case 'select|sort' --output base.json
+#
+# Compare two results. It exits with 1 when a case is regressed:
+#   % ruby benchmark/suite.rb compare base.json target.json --threshold 0.05
+#
+# Each case has the following values:
+#   * elapsed: The total time of measured operations in seconds.
+#   * operations_per_second: It's computed from the measured time.
+#     Setup in a case isn't included.
+#   * p50, p99, max: Latency of an operation in seconds.
+#   * rss_before_kb, rss_after_kb: RSS around the case.
+#   * gc: The number of GC runs and allocated objects in the case.
+
+require "json"
+require "optparse"
+
+base_dir = File.expand_path(File.join(File.dirname(__FILE__), ".."))
+$LOAD_PATH.unshift(File.join(base_dir, "ext", "groonga"))
+$LOAD_PATH.unshift(File.join(base_dir, "lib"))
+$LOAD_PATH.unshift(File.dirname(__FILE__))
+
+def run_suite(argv)
+  require "groonga"
+  require "suite/corpus"
+  require "suite/runner"
+
+  corpus_options = {}
+  runner_options = {:progress_output => $stderr}
+  output_path = nil
+  parser = OptionParser.new
+  parser.banner = "Usage: #{$0} run [options]"
+  parser.on("--seed=SEED", Integer,
+            "Seed for the corpus generator") do |seed|
+    corpus_options[:seed] = seed
+  end
+  parser.on("--n-documents=N", Integer,
+            "The number of generated documents") do |n|
+    corpus_options[:n_documents] = n
+  end
+  parser.on("--n-words=N", Integer,
+            "The size of the generated vocabulary") do |n|
+    corpus_options[:n_words] = n
+  end
+  parser.on("--iterations=N", Integer,
+            "The number of iterations of each case") do |n|
+    runner_options[:iterations] = n
+  end
+  parser.on("--case=PATTERN", Regexp,
+            "Report only cases that match PATTERN",
+            "(setup cases such as bulk_add are always run)") do |pattern|
+    runner_options[:pattern] = pattern
+  end
+  parser.on("--output=PATH",
+            "Write the result to PATH instead of the standard output") do |path|
+    output_path = path
+  end
+  parser.parse!(argv)
+
+  corpus = BenchmarkSuite::Corpus.new(corpus_options)
+  result = BenchmarkSuite::Runner.new(corpus, runner_options).run
+  json = JSON.pretty_generate(result)
+  if output_path
+    File.write(output_path, json + "\n")
+  else
+    puts(json)
+  end
+  true
+end
+
+def compare_results(argv)
+  require "suite/comparator"
+
+  options = {}
+  parser = OptionParser.new
+  parser.banner = "Usage: #{$0} compare [options] BASE.json TARGET.json"
+  parser.on("--threshold=RATE", Float,
+            "Report a regression when a case is slower than RATE",
+            "(0.05)") do |threshold|
+    options[:threshold] = threshold
+  end
+  parser.parse!(argv)
+  if argv.size != 2
+    $stderr.puts(parser.help)
+    return false
+  end
+
+  base, target = argv.collect do |path|
+    JSON.parse(File.read(path))
+  end
+  comparator = BenchmarkSuite::Comparator.new(base, target, options)
+  comparator.report($stdout)
+  comparator.regressions.empty?
+end
+
+command = ARGV.shift
+case command
+when "run"
+  success = run_suite(ARGV)
+when "compare"
+  success = compare_results(ARGV)
+else
+  $stderr.puts("Usage: #{$0} run|compare [options]")
+  success = false
+end
+exit(success)
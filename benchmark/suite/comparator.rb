@@ -0,0 +1,116 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module BenchmarkSuite
+  # Compares two benchmark results. A case is a regression when its
+  # throughput drops or its p99 latency grows more than the
+  # threshold.
+  class Comparator
+    Row = Struct.new(:name,
+                     :base_operations_per_second,
+                     :target_operations_per_second,
+                     :base_p99,
+                     :target_p99) do
+      def throughput_change
+        change(base_operations_per_second, target_operations_per_second)
+      end
+
+      def p99_change
+        change(base_p99, target_p99)
+      end
+
+      private
+      def change(base, target)
+        return 0.0 if base.nil? or target.nil? or base.zero?
+        (target - base) / base.to_f
+      end
+    end
+
+    attr_reader :warnings
+    def initialize(base, target, options={})
+      @base = base
+      @target = target
+      @threshold = options[:threshold] || 0.05
+      @warnings = []
+      check_metadata
+    end
+
+    def rows
+      @rows ||= (@base["cases"].keys & @target["cases"].keys).collect do |name|
+        base = @base["cases"][name]
+        target = @target["cases"][name]
+        Row.new(name,
+                base["operations_per_second"],
+                target["operations_per_second"],
+                base["p99"],
+                target["p99"])
+      end
+    end
+
+    def regression?(row)
+      row.throughput_change < -@threshold or row.p99_change > @threshold
+    end
+
+    def regressions
+      rows.select {|row| regression?(row)}
+    end
+
+    def report(output)
+      @warnings.each do |warning|
+        output.puts("WARNING: #{warning}")
+      end
+      width = (rows.collect {|row| row.name.size} + ["case".size]).max
+      output.puts([
+                    "case".ljust(width),
+                    "base ops/s".rjust(12),
+                    "target ops/s".rjust(12),
+                    "change".rjust(8),
+                    "base p99".rjust(11),
+                    "target p99".rjust(11),
+                    "change".rjust(8),
+                    "",
+                  ].join(" "))
+      rows.each do |row|
+        output.puts([
+                      row.name.ljust(width),
+                      "%12.1f" % row.base_operations_per_second,
+                      "%12.1f" % row.target_operations_per_second,
+                      format_change(row.throughput_change),
+                      format_latency(row.base_p99),
+                      format_latency(row.target_p99),
+                      format_change(row.p99_change),
+                      regression?(row) ? "REGRESSION" : "",
+                    ].join(" "))
+      end
+    end
+
+    private
+    def check_metadata
+      base_metadata = @base["metadata"] || {}
+      target_metadata = @target["metadata"] || {}
+      ["corpus_digest", "iterations", "host"].each do |name|
+        next if base_metadata[name] == target_metadata[name]
+        @warnings << "#{name} differs: " +
+          "#{base_metadata[name].inspect} -> #{target_metadata[name].inspect}"
+      end
+    end
+
+    def format_change(change)
+      "%+7.1f%%" % (change * 100)
+    end
+
+    def format_latency(seconds)
+      "%9.3fms" % (seconds * 1000)
+    end
+  end
+end
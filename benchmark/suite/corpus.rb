@@ -0,0 +1,130 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "digest/sha1"
+
+module BenchmarkSuite
+  # Generates a deterministic synthetic corpus. The same seed and
+  # the same parameters always generate the same documents on any
+  # platform because only Random#rand with an explicit seed is used.
+  #
+  # Words are picked with a log-uniform distribution. It
+  # approximates the Zipf-like term distribution of natural language
+  # text: a few words are very frequent and most words are rare.
+  class Corpus
+    SYLLABLES = [
+      "ka", "ki", "ku", "ke", "ko",
+      "sa", "shi", "su", "se", "so",
+      "ta", "chi", "tsu", "te", "to",
+      "na", "ni", "nu", "ne", "no",
+      "ma", "mi", "mu", "me", "mo",
+      "ra", "ri", "ru", "re", "ro",
+      "ga", "gi", "gu", "ge", "go",
+      "n",
+    ]
+
+    BASE_TIME = Time.utc(2020, 1, 1)
+
+    attr_reader :seed
+    attr_reader :n_documents
+    attr_reader :n_words
+    attr_reader :n_categories
+    def initialize(options={})
+      @seed = options[:seed] || 29
+      @n_documents = options[:n_documents] || 10000
+      @n_words = options[:n_words] || 5000
+      @n_categories = options[:n_categories] || 20
+      @words = nil
+      @documents = nil
+    end
+
+    def words
+      @words ||= generate_words
+    end
+
+    def categories
+      @categories ||= @n_categories.times.collect do |i|
+        "category%02d" % i
+      end
+    end
+
+    # @return [::Array<::Hash>] The documents. Each document has
+    #   `:_key`, `:title`, `:body`, `:category`, `:score` and
+    #   `:created_at`.
+    def documents
+      @documents ||= generate_documents
+    end
+
+    # @return [::Array<String>] The words for full-text search. They
+    #   are picked from the middle of the frequency distribution to
+    #   avoid both too many and too few hits.
+    def query_words(n=100)
+      random = Random.new(@seed + 1)
+      from = words.size / 100
+      to = words.size / 10
+      n.times.collect do
+        words[from + random.rand(to - from)]
+      end
+    end
+
+    # @return [String] The digest of the generated documents. Runs
+    #   with different digests aren't comparable.
+    def digest
+      sha1 = Digest::SHA1.new
+      documents.each do |document|
+        sha1 << document[:_key]
+        sha1 << document[:body]
+      end
+      sha1.hexdigest
+    end
+
+    private
+    def generate_words
+      random = Random.new(@seed)
+      words = {}
+      until words.size == @n_words
+        n_syllables = 2 + random.rand(3)
+        word = n_syllables.times.collect do
+          SYLLABLES[random.rand(SYLLABLES.size)]
+        end.join
+        words[word] = true
+      end
+      words.keys
+    end
+
+    def pick_word(random)
+      index = (@n_words ** random.rand).to_i - 1
+      words[index]
+    end
+
+    def generate_sentence(random, n_words)
+      n_words.times.collect do
+        pick_word(random)
+      end.join(" ")
+    end
+
+    def generate_documents
+      random = Random.new(@seed)
+      @n_documents.times.collect do |i|
+        {
+          :_key => "doc%08d" % i,
+          :title => generate_sentence(random, 3 + random.rand(6)),
+          :body => generate_sentence(random, 30 + random.rand(90)),
+          :category => categories[random.rand(categories.size)],
+          :score => random.rand(1000),
+          :created_at => BASE_TIME + i * 60,
+        }
+      end
+    end
+  end
+end
@@ -0,0 +1,323 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "fileutils"
+require "time"
+require "tmpdir"
+require "etc"
+require "stringio"
+
+module BenchmarkSuite
+  class Recorder
+    attr_reader :latencies
+    def initialize
+      @latencies = []
+    end
+
+    def measure
+      start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      result = yield
+      @latencies << Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+      result
+    end
+  end
+
+  # Runs benchmark cases against a database built from a {Corpus}.
+  # Cases are run in the defined order because later cases use the
+  # records added by "bulk_add". Setup cases such as "bulk_add" are
+  # always run. The pattern selects only reported cases.
+  class Runner
+    Case = Struct.new(:name, :description, :before, :block, :setup) do
+      def setup?
+        setup
+      end
+    end
+
+    def initialize(corpus, options={})
+      @corpus = corpus
+      @iterations = options[:iterations] || 3
+      @pattern = options[:pattern]
+      @output = options[:progress_output]
+      @cases = []
+      define_cases
+    end
+
+    def run
+      results = {}
+      Dir.mktmpdir("rroonga-benchmark") do |dir|
+        Groonga::Context.open(:encoding => :utf8) do |context|
+          @context = context
+          @database = Groonga::Database.create(:context => context,
+                                               :path => File.join(dir, "db"))
+          define_schema
+          @cases.each do |benchmark_case|
+            if @pattern and @pattern !~ benchmark_case.name
+              next unless benchmark_case.setup?
+              @output.puts("#{benchmark_case.name} (setup)...") if @output
+              set_up(benchmark_case)
+              next
+            end
+            @output.puts("#{benchmark_case.name}...") if @output
+            results[benchmark_case.name] = run_case(benchmark_case)
+          end
+          @database.close
+        end
+      end
+      {
+        "metadata" => metadata,
+        "cases" => results,
+      }
+    end
+
+    private
+    def metadata
+      {
+        "created_at" => Time.now.utc.iso8601,
+        "host" => Etc.uname[:nodename],
+        "platform" => RUBY_PLATFORM,
+        "ruby_version" => RUBY_VERSION,
+        "groonga_version" => Groonga.version,
+        "rroonga_version" => Groonga.bindings_version,
+        "seed" => @corpus.seed,
+        "n_documents" => @corpus.n_documents,
+        "n_words" => @corpus.n_words,
+        "corpus_digest" => @corpus.digest,
+        "iterations" => @iterations,
+      }
+    end
+
+    def define_case(name, description, options={}, &block)
+      @cases << Case.new(name,
+                         description,
+                         options[:before],
+                         block,
+                         options[:setup] || false)
+    end
+
+    def define_schema
+      Groonga::Schema.define(:context => @context) do |schema|
+        schema.create_table("Categories",
+                            :type => :hash,
+                            :key_type => :short_text) do |table|
+        end
+
+        schema.create_table("Documents",
+                            :type => :hash,
+                            :key_type => :short_text) do |table|
+          table.short_text("title")
+          table.text("body")
+          table.reference("category", "Categories")
+          table.int32("score")
+          table.time("created_at")
+        end
+
+        schema.create_table("Terms",
+                            :type => :patricia_trie,
+                            :key_type => :short_text,
+                            :normalizer => "NormalizerAuto",
+                            :default_tokenizer => "TokenBigram") do |table|
+          table.index("Documents.body", :with_position => true)
+        end
+      end
+      @documents = @context["Documents"]
+    end
+
+    def define_cases
+      define_case("bulk_add", "Add all documents with columns",
+                  :before => lambda {@documents.truncate},
+                  :setup => true) do |recorder|
+        @corpus.documents.each do |document|
+          key = document[:_key]
+          values = document.reject {|name, _| name == :_key}
+          recorder.measure do
+            @documents.add(key, values)
+          end
+        end
+      end
+
+      define_case("key_lookup", "Look up all documents by key") do |recorder|
+        @corpus.documents.each do |document|
+          recorder.measure do
+            @documents[document[:_key]]
+          end
+        end
+      end
+
+      define_case("column_read", "Read a fixed size column value") do |recorder|
+        score = @documents.column("score")
+        @documents.each do |record|
+          id = record.id
+          recorder.measure do
+            score[id]
+          end
+        end
+      end
+
+      define_case("column_write", "Write a fixed size column value") do |recorder|
+        score = @documents.column("score")
+        @documents.each do |record|
+          id = record.id
+          # Write the current value back. Other cases such as "sort"
+          # read the column, so its data must not be changed.
+          value = score[id]
+          recorder.measure do
+            score[id] = value
+          end
+        end
+      end
+
+      define_case("fulltext_select", "Full-text search by a word") do |recorder|
+        @corpus.query_words.each do |word|
+          recorder.measure do
+            result = @documents.select do |record|
+              record.body =~ word
+            end
+            result.close
+          end
+        end
+      end
+
+      define_case("sort", "Sort all documents by score and take top 100") do |recorder|
+        10.times do
+          recorder.measure do
+            sorted = @documents.sort([["score", :desc]], :limit => 100)
+            sorted.close
+          end
+        end
+      end
+
+      define_case("group", "Group all documents by category") do |recorder|
+        10.times do
+          recorder.measure do
+            grouped = @documents.group("category")
+            grouped.close
+          end
+        end
+      end
+
+      define_case("snippet", "Make snippets of matched documents") do |recorder|
+        @corpus.query_words(10).each do |word|
+          snippet = Groonga::Snippet.new(:context => @context,
+                                         :normalize => true,
+                                         :width => 100)
+          snippet.add_keyword(word, :open_tag => "<b>", :close_tag => "</b>")
+          result = @documents.select do |record|
+            record.body =~ word
+          end
+          result.each do |record|
+            body = record.body
+            recorder.measure do
+              snippet.execute(body)
+            end
+          end
+          result.close
+          snippet.close
+        end
+      end
+
+      define_case("dump_restore", "Dump the database and restore it") do |recorder|
+        dumped = recorder.measure do
+          output = StringIO.new
+          Groonga::DatabaseDumper.dump(:context => @context,
+                                       :database => @database,
+                                       :output => output)
+          output.string
+        end
+        Groonga::Context.open(:encoding => :utf8) do |context|
+          Dir.mktmpdir("rroonga-benchmark-restore") do |dir|
+            database = Groonga::Database.create(:context => context,
+                                                :path => File.join(dir, "db"))
+            recorder.measure do
+              context.restore(dumped)
+            end
+            database.close
+          end
+        end
+      end
+
+      define_case("reindex", "Rebuild the full-text index") do |recorder|
+        index = @context["Terms.Documents_body"]
+        recorder.measure do
+          index.reindex
+        end
+      end
+    end
+
+    def set_up(benchmark_case)
+      benchmark_case.before.call if benchmark_case.before
+      benchmark_case.block.call(Recorder.new)
+    end
+
+    def run_case(benchmark_case)
+      recorder = Recorder.new
+      GC.start
+      rss_before = rss_kb
+      gc_before = GC.stat
+      @iterations.times do
+        benchmark_case.before.call if benchmark_case.before
+        benchmark_case.block.call(recorder)
+      end
+      gc_after = GC.stat
+      rss_after = rss_kb
+
+      latencies = recorder.latencies.sort
+      n_operations = latencies.size
+      # Only measured operations are counted. Setup in a case such
+      # as the select in "snippet" isn't included.
+      elapsed = latencies.sum(0.0)
+      {
+        "description" => benchmark_case.description,
+        "n_operations" => n_operations,
+        "elapsed" => elapsed,
+        "operations_per_second" => elapsed.zero? ? 0.0 : n_operations / elapsed,
+        "p50" => percentile(latencies, 0.50),
+        "p99" => percentile(latencies, 0.99),
+        "max" => latencies.last || 0.0,
+        "rss_before_kb" => rss_before,
+        "rss_after_kb" => rss_after,
+        "gc" => {
+          "count" => gc_after[:count] - gc_before[:count],
+          "minor_count" => gc_diff(gc_before, gc_after, :minor_gc_count),
+          "major_count" => gc_diff(gc_before, gc_after, :major_gc_count),
+          "allocated_objects" => gc_diff(gc_before, gc_after,
+                                         :total_allocated_objects),
+        },
+      }
+    end
+
+    def percentile(sorted_values, rate)
+      return 0.0 if sorted_values.empty?
+      index = (sorted_values.size * rate).ceil - 1
+      index = 0 if index < 0
+      sorted_values[index]
+    end
+
+    def gc_diff(before, after, key)
+      return nil unless after.key?(key)
+      after[key] - before[key]
+    end
+
+    def rss_kb
+      status_path = "/proc/self/status"
+      if File.readable?(status_path)
+        File.foreach(status_path) do |line|
+          return Integer($1, 10) if /\AVmRSS:\s*(\d+)/ =~ line
+        end
+      end
+      rss = `ps -o rss= -p #{Process.pid}`.strip
+      rss.empty? ? nil : Integer(rss, 10)
+    rescue SystemCallError
+      nil
+    end
+  end
+end
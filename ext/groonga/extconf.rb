@@ -254,6 +254,7 @@ have_func("rb_sym2str", "ruby.h")
 have_func("rb_to_symbol", "ruby.h")
 have_func("rb_ary_new_from_args", "ruby.h")
 have_func("rb_ary_new_from_values", "ruby.h")
+have_func("rb_enc_interned_str", "ruby/encoding.h")
 have_type("enum ruby_value_type", "ruby.h")
 
 checking_for(checking_message("--enable-debug-log option")) do
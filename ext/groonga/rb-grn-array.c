@@ -177,21 +177,125 @@ rb_grn_array_add (int argc, VALUE *argv, VALUE self)
     grn_obj *table;
     grn_id id;
     VALUE values;
+    uint64_t metrics_start;
 
     rb_scan_args(argc, argv, "01", &values);
 
     table = SELF(self, &context);
 
+    metrics_start = RB_GRN_METRICS_START();
     id = grn_table_add(context, table, NULL, 0, NULL);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_ADD, metrics_start);
     rb_grn_context_check(context, self);
 
     if (GRN_ID_NIL == id) {
         return Qnil;
     } else {
+        rb_grn_context_record_change(context, RB_GRN_CHANGE_ADD, table, id);
         return rb_grn_record_new_added(self, id, values);
     }
 }
 
+/*
+ * Adds _n_ records in one call. Values of the records aren't
+ * set.
+ *
+ * It's faster than calling {#add} _n_ times because no
+ * {Groonga::Record} is created.
+ *
+ * @example Add 3 records and set their values
+ *   ids = users.add_many(3) # => 1..3
+ *   names = users.column("name")
+ *   ids.zip(["mori", "kou", "yu"]) do |id, name|
+ *     names[id] = name
+ *   end
+ *
+ * @overload add_many(n)
+ *   @param n [Integer] The number of records to be added.
+ *   @return [::Range<Integer>, ::Array<Integer>] The IDs of the
+ *     added records. They're contiguous and returned as a
+ *     {::Range} when the array has no deleted records. Otherwise
+ *     deleted IDs are reused and they're returned as an
+ *     {::Array}.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_array_add_many (VALUE self, VALUE rb_n)
+{
+    grn_ctx *context = NULL;
+    grn_obj *table;
+    long i, n;
+    grn_id first_id = GRN_ID_NIL;
+    grn_id previous_id = GRN_ID_NIL;
+    grn_bool contiguous = GRN_TRUE;
+    VALUE rb_ids = Qnil;
+    uint64_t metrics_start;
+
+    n = NUM2LONG(rb_n);
+    if (n < 0) {
+        rb_raise(rb_eArgError,
+                 "the number of records must not be negative: <%ld>", n);
+    }
+
+    table = SELF(self, &context);
+
+    if (n == 0)
+        return rb_ary_new();
+
+    metrics_start = RB_GRN_METRICS_START();
+    for (i = 0; i < n; i++) {
+        grn_id id;
+
+        id = grn_table_add(context, table, NULL, 0, NULL);
+        if (id == GRN_ID_NIL)
+            break;
+
+        if (i == 0) {
+            first_id = id;
+        } else if (contiguous && id != previous_id + 1) {
+            grn_id contiguous_id;
+
+            contiguous = GRN_FALSE;
+            rb_ids = rb_ary_new_capa(n);
+            for (contiguous_id = first_id;
+                 contiguous_id <= previous_id;
+                 contiguous_id++) {
+                rb_ary_push(rb_ids, UINT2NUM(contiguous_id));
+            }
+        }
+        if (!contiguous)
+            rb_ary_push(rb_ids, UINT2NUM(id));
+        previous_id = id;
+    }
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_ADD, metrics_start);
+    rb_grn_context_check(context, self);
+
+    if (first_id != GRN_ID_NIL &&
+        rb_grn_context_is_recording_changes(context)) {
+        if (contiguous) {
+            grn_id id;
+            for (id = first_id; id <= previous_id; id++) {
+                rb_grn_context_record_change(context, RB_GRN_CHANGE_ADD,
+                                             table, id);
+            }
+        } else {
+            long n_ids = RARRAY_LEN(rb_ids);
+            for (i = 0; i < n_ids; i++) {
+                rb_grn_context_record_change(context, RB_GRN_CHANGE_ADD,
+                                             table,
+                                             NUM2UINT(RARRAY_AREF(rb_ids, i)));
+            }
+        }
+    }
+
+    if (!contiguous)
+        return rb_ids;
+    if (first_id == GRN_ID_NIL)
+        return rb_ary_new();
+    return rb_range_new(UINT2NUM(first_id), UINT2NUM(previous_id), GRN_FALSE);
+}
+
 void
 rb_grn_init_array (VALUE mGrn)
 {
@@ -201,4 +305,5 @@ rb_grn_init_array (VALUE mGrn)
                                rb_grn_array_s_create, -1);
 
     rb_define_method(rb_cGrnArray, "add", rb_grn_array_add, -1);
+    rb_define_method(rb_cGrnArray, "add_many", rb_grn_array_add_many, 1);
 }
@@ -0,0 +1,1252 @@
+/* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License version 2.1 as published by the Free Software Foundation.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "rb-grn.h"
+
+#include <string.h>
+
+/*
+ * Document-class: Groonga::Bitmap
+ *
+ * This is a compressed set of record IDs. It's useful to combine
+ * large hit lists such as facet filters that match millions of
+ * records. Set operations on it are much cheaper than
+ * {Groonga::Table#union!}, {Groonga::Table#intersection!} and so
+ * on because they don't build and probe temporary hash tables.
+ *
+ * IDs are partitioned into chunks by their upper 16 bits. A chunk
+ * that has few IDs is stored as a sorted array of their lower 16
+ * bits. A dense chunk is stored as a 65536 bits bitset. Set
+ * operations between bitsets process 64 bits per step.
+ *
+ * Use {Groonga::Bitmap.from_table} to create a bitmap from a
+ * result table and {#to_table} to create a result table from a
+ * bitmap.
+ *
+ * @since 12.0.9
+ */
+
+VALUE rb_cGrnBitmap;
+
+#define SELF(object) (rb_grn_bitmap_get(object))
+
+/* An array container that has more values than this is
+   converted to a bitset container. An array container of this
+   size uses the same memory as a bitset container. */
+#define ARRAY_CONTAINER_MAX_SIZE 4096
+#define N_BITSET_WORDS (65536 / 64)
+
+#define ID_HIGH(id) ((uint16_t)((id) >> 16))
+#define ID_LOW(id) ((uint16_t)((id) & 0xffff))
+#define ID_COMPOSE(high, low) ((((grn_id)(high)) << 16) | (grn_id)(low))
+
+typedef struct {
+    uint16_t key;
+    grn_bool is_bitset;
+    uint32_t size;
+    uint32_t capacity;
+    union {
+        uint16_t *values;
+        uint64_t *words;
+    } data;
+} RbGrnBitmapContainer;
+
+typedef struct {
+    RbGrnBitmapContainer *containers;
+    uint32_t n_containers;
+    uint32_t capacity;
+} RbGrnBitmap;
+
+static int
+popcount64 (uint64_t word)
+{
+#ifdef __GNUC__
+    return __builtin_popcountll(word);
+#else
+    int n = 0;
+    while (word) {
+        word &= word - 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static void
+container_fin (RbGrnBitmapContainer *container)
+{
+    if (container->is_bitset) {
+        xfree(container->data.words);
+    } else {
+        xfree(container->data.values);
+    }
+}
+
+static void
+container_init_array (RbGrnBitmapContainer *container,
+                      uint16_t key,
+                      uint32_t capacity)
+{
+    container->key = key;
+    container->is_bitset = GRN_FALSE;
+    container->size = 0;
+    if (capacity < 4)
+        capacity = 4;
+    container->capacity = capacity;
+    container->data.values = ALLOC_N(uint16_t, capacity);
+}
+
+static void
+container_fill_words (RbGrnBitmapContainer *container, uint64_t *words)
+{
+    uint32_t i;
+
+    if (container->is_bitset) {
+        memcpy(words, container->data.words, sizeof(uint64_t) * N_BITSET_WORDS);
+        return;
+    }
+
+    memset(words, 0, sizeof(uint64_t) * N_BITSET_WORDS);
+    for (i = 0; i < container->size; i++) {
+        uint16_t value = container->data.values[i];
+        words[value / 64] |= ((uint64_t)1) << (value % 64);
+    }
+}
+
+/* Takes the ownership of words. */
+static void
+container_init_words (RbGrnBitmapContainer *container,
+                      uint16_t key,
+                      uint64_t *words)
+{
+    uint32_t i, size = 0;
+
+    for (i = 0; i < N_BITSET_WORDS; i++) {
+        size += popcount64(words[i]);
+    }
+
+    if (size > ARRAY_CONTAINER_MAX_SIZE) {
+        container->key = key;
+        container->is_bitset = GRN_TRUE;
+        container->size = size;
+        container->capacity = 0;
+        container->data.words = words;
+        return;
+    }
+
+    container_init_array(container, key, size);
+    for (i = 0; i < N_BITSET_WORDS; i++) {
+        uint64_t word = words[i];
+        while (word) {
+            int bit = popcount64((word & -word) - 1);
+            container->data.values[container->size++] = (uint16_t)(i * 64 + bit);
+            word &= word - 1;
+        }
+    }
+    xfree(words);
+}
+
+static int
+container_find (RbGrnBitmapContainer *container, uint16_t value,
+                uint32_t *position)
+{
+    uint32_t low = 0, high = container->size;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        uint16_t middle_value = container->data.values[middle];
+        if (middle_value == value) {
+            *position = middle;
+            return GRN_TRUE;
+        } else if (middle_value < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    *position = low;
+    return GRN_FALSE;
+}
+
+static grn_bool
+container_contains (RbGrnBitmapContainer *container, uint16_t value)
+{
+    uint32_t position;
+
+    if (container->is_bitset) {
+        return (container->data.words[value / 64] >> (value % 64)) & 1;
+    } else {
+        return container_find(container, value, &position);
+    }
+}
+
+static grn_bool
+container_add (RbGrnBitmapContainer *container, uint16_t value)
+{
+    uint32_t position;
+
+    if (container->is_bitset) {
+        uint64_t mask = ((uint64_t)1) << (value % 64);
+        if (container->data.words[value / 64] & mask)
+            return GRN_FALSE;
+        container->data.words[value / 64] |= mask;
+        container->size++;
+        return GRN_TRUE;
+    }
+
+    /* Fast path for IDs added in ascending order. */
+    if (container->size == 0 ||
+        container->data.values[container->size - 1] < value) {
+        position = container->size;
+    } else if (container_find(container, value, &position)) {
+        return GRN_FALSE;
+    }
+
+    if (container->size == ARRAY_CONTAINER_MAX_SIZE) {
+        uint64_t *words = ALLOC_N(uint64_t, N_BITSET_WORDS);
+        container_fill_words(container, words);
+        xfree(container->data.values);
+        container->is_bitset = GRN_TRUE;
+        container->capacity = 0;
+        container->data.words = words;
+        return container_add(container, value);
+    }
+
+    if (container->size == container->capacity) {
+        container->capacity *= 2;
+        if (container->capacity > ARRAY_CONTAINER_MAX_SIZE)
+            container->capacity = ARRAY_CONTAINER_MAX_SIZE;
+        REALLOC_N(container->data.values, uint16_t, container->capacity);
+    }
+    memmove(container->data.values + position + 1,
+            container->data.values + position,
+            sizeof(uint16_t) * (container->size - position));
+    container->data.values[position] = value;
+    container->size++;
+    return GRN_TRUE;
+}
+
+static grn_bool
+container_delete (RbGrnBitmapContainer *container, uint16_t value)
+{
+    uint32_t position;
+
+    if (container->is_bitset) {
+        uint64_t mask = ((uint64_t)1) << (value % 64);
+        if (!(container->data.words[value / 64] & mask))
+            return GRN_FALSE;
+        container->data.words[value / 64] &= ~mask;
+        container->size--;
+        return GRN_TRUE;
+    }
+
+    if (!container_find(container, value, &position))
+        return GRN_FALSE;
+    memmove(container->data.values + position,
+            container->data.values + position + 1,
+            sizeof(uint16_t) * (container->size - position - 1));
+    container->size--;
+    return GRN_TRUE;
+}
+
+static void
+container_and (RbGrnBitmapContainer *result,
+               RbGrnBitmapContainer *a,
+               RbGrnBitmapContainer *b)
+{
+    uint32_t i;
+
+    if (!a->is_bitset && !b->is_bitset) {
+        uint32_t j = 0;
+        container_init_array(result, a->key,
+                             a->size < b->size ? a->size : b->size);
+        i = 0;
+        while (i < a->size && j < b->size) {
+            uint16_t a_value = a->data.values[i];
+            uint16_t b_value = b->data.values[j];
+            if (a_value == b_value) {
+                result->data.values[result->size++] = a_value;
+                i++;
+                j++;
+            } else if (a_value < b_value) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+    } else if (!a->is_bitset || !b->is_bitset) {
+        RbGrnBitmapContainer *array = a->is_bitset ? b : a;
+        RbGrnBitmapContainer *bitset = a->is_bitset ? a : b;
+        container_init_array(result, a->key, array->size);
+        for (i = 0; i < array->size; i++) {
+            uint16_t value = array->data.values[i];
+            if (container_contains(bitset, value))
+                result->data.values[result->size++] = value;
+        }
+    } else {
+        uint64_t *words = ALLOC_N(uint64_t, N_BITSET_WORDS);
+        for (i = 0; i < N_BITSET_WORDS; i++) {
+            words[i] = a->data.words[i] & b->data.words[i];
+        }
+        container_init_words(result, a->key, words);
+    }
+}
+
+static void
+container_or (RbGrnBitmapContainer *result,
+              RbGrnBitmapContainer *a,
+              RbGrnBitmapContainer *b)
+{
+    uint32_t i;
+
+    if (!a->is_bitset && !b->is_bitset &&
+        a->size + b->size <= ARRAY_CONTAINER_MAX_SIZE) {
+        uint32_t j = 0;
+        container_init_array(result, a->key, a->size + b->size);
+        i = 0;
+        while (i < a->size || j < b->size) {
+            uint16_t value;
+            if (j == b->size ||
+                (i < a->size && a->data.values[i] < b->data.values[j])) {
+                value = a->data.values[i++];
+            } else if (i == a->size ||
+                       b->data.values[j] < a->data.values[i]) {
+                value = b->data.values[j++];
+            } else {
+                value = a->data.values[i++];
+                j++;
+            }
+            result->data.values[result->size++] = value;
+        }
+    } else {
+        uint64_t *words = ALLOC_N(uint64_t, N_BITSET_WORDS);
+        container_fill_words(a, words);
+        if (b->is_bitset) {
+            for (i = 0; i < N_BITSET_WORDS; i++) {
+                words[i] |= b->data.words[i];
+            }
+        } else {
+            for (i = 0; i < b->size; i++) {
+                uint16_t value = b->data.values[i];
+                words[value / 64] |= ((uint64_t)1) << (value % 64);
+            }
+        }
+        container_init_words(result, a->key, words);
+    }
+}
+
+static void
+container_and_not (RbGrnBitmapContainer *result,
+                   RbGrnBitmapContainer *a,
+                   RbGrnBitmapContainer *b)
+{
+    uint32_t i;
+
+    if (!a->is_bitset) {
+        container_init_array(result, a->key, a->size);
+        for (i = 0; i < a->size; i++) {
+            uint16_t value = a->data.values[i];
+            if (!container_contains(b, value))
+                result->data.values[result->size++] = value;
+        }
+    } else {
+        uint64_t *words = ALLOC_N(uint64_t, N_BITSET_WORDS);
+        if (b->is_bitset) {
+            for (i = 0; i < N_BITSET_WORDS; i++) {
+                words[i] = a->data.words[i] & ~(b->data.words[i]);
+            }
+        } else {
+            memcpy(words, a->data.words, sizeof(uint64_t) * N_BITSET_WORDS);
+            for (i = 0; i < b->size; i++) {
+                uint16_t value = b->data.values[i];
+                words[value / 64] &= ~(((uint64_t)1) << (value % 64));
+            }
+        }
+        container_init_words(result, a->key, words);
+    }
+}
+
+static void
+container_copy (RbGrnBitmapContainer *result, RbGrnBitmapContainer *source)
+{
+    if (source->is_bitset) {
+        uint64_t *words = ALLOC_N(uint64_t, N_BITSET_WORDS);
+        memcpy(words, source->data.words, sizeof(uint64_t) * N_BITSET_WORDS);
+        *result = *source;
+        result->data.words = words;
+    } else {
+        container_init_array(result, source->key, source->size);
+        memcpy(result->data.values, source->data.values,
+               sizeof(uint16_t) * source->size);
+        result->size = source->size;
+    }
+}
+
+static void
+rb_grn_bitmap_clear (RbGrnBitmap *bitmap)
+{
+    uint32_t i;
+
+    for (i = 0; i < bitmap->n_containers; i++) {
+        container_fin(&(bitmap->containers[i]));
+    }
+    xfree(bitmap->containers);
+    bitmap->containers = NULL;
+    bitmap->n_containers = 0;
+    bitmap->capacity = 0;
+}
+
+static void
+rb_grn_bitmap_free (void *data)
+{
+    RbGrnBitmap *bitmap = data;
+
+    rb_grn_bitmap_clear(bitmap);
+    xfree(bitmap);
+}
+
+static size_t
+rb_grn_bitmap_memsize (const void *data)
+{
+    const RbGrnBitmap *bitmap = data;
+    size_t size;
+    uint32_t i;
+
+    size = sizeof(RbGrnBitmap);
+    size += sizeof(RbGrnBitmapContainer) * bitmap->capacity;
+    for (i = 0; i < bitmap->n_containers; i++) {
+        const RbGrnBitmapContainer *container = &(bitmap->containers[i]);
+        if (container->is_bitset) {
+            size += sizeof(uint64_t) * N_BITSET_WORDS;
+        } else {
+            size += sizeof(uint16_t) * container->capacity;
+        }
+    }
+    return size;
+}
+
+static rb_data_type_t data_type = {
+    "Groonga::Bitmap",
+    {
+        NULL,
+        rb_grn_bitmap_free,
+        rb_grn_bitmap_memsize,
+    },
+    NULL,
+    NULL,
+    RUBY_TYPED_FREE_IMMEDIATELY
+};
+
+static RbGrnBitmap *
+rb_grn_bitmap_get (VALUE rb_bitmap)
+{
+    RbGrnBitmap *bitmap;
+
+    TypedData_Get_Struct(rb_bitmap, RbGrnBitmap, &data_type, bitmap);
+    return bitmap;
+}
+
+static VALUE
+rb_grn_bitmap_alloc (VALUE klass)
+{
+    RbGrnBitmap *bitmap;
+    VALUE rb_bitmap;
+
+    rb_bitmap = TypedData_Make_Struct(klass, RbGrnBitmap, &data_type, bitmap);
+    bitmap->containers = NULL;
+    bitmap->n_containers = 0;
+    bitmap->capacity = 0;
+    return rb_bitmap;
+}
+
+static RbGrnBitmapContainer *
+rb_grn_bitmap_append_container (RbGrnBitmap *bitmap)
+{
+    if (bitmap->n_containers == bitmap->capacity) {
+        bitmap->capacity = bitmap->capacity == 0 ? 4 : bitmap->capacity * 2;
+        REALLOC_N(bitmap->containers, RbGrnBitmapContainer, bitmap->capacity);
+    }
+    return &(bitmap->containers[bitmap->n_containers++]);
+}
+
+static RbGrnBitmapContainer *
+rb_grn_bitmap_find_container (RbGrnBitmap *bitmap, uint16_t key,
+                              uint32_t *position)
+{
+    uint32_t low = 0, high = bitmap->n_containers;
+
+    /* Fast path for IDs added in ascending order. */
+    if (high > 0 && bitmap->containers[high - 1].key <= key) {
+        if (bitmap->containers[high - 1].key == key) {
+            *position = high - 1;
+            return &(bitmap->containers[high - 1]);
+        }
+        *position = high;
+        return NULL;
+    }
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        uint16_t middle_key = bitmap->containers[middle].key;
+        if (middle_key == key) {
+            *position = middle;
+            return &(bitmap->containers[middle]);
+        } else if (middle_key < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    *position = low;
+    return NULL;
+}
+
+static grn_bool
+rb_grn_bitmap_add_id (RbGrnBitmap *bitmap, grn_id id)
+{
+    RbGrnBitmapContainer *container;
+    uint32_t position;
+
+    container = rb_grn_bitmap_find_container(bitmap, ID_HIGH(id), &position);
+    if (!container) {
+        rb_grn_bitmap_append_container(bitmap);
+        memmove(bitmap->containers + position + 1,
+                bitmap->containers + position,
+                sizeof(RbGrnBitmapContainer) *
+                (bitmap->n_containers - 1 - position));
+        container = &(bitmap->containers[position]);
+        container_init_array(container, ID_HIGH(id), 0);
+    }
+    return container_add(container, ID_LOW(id));
+}
+
+static grn_bool
+rb_grn_bitmap_delete_id (RbGrnBitmap *bitmap, grn_id id)
+{
+    RbGrnBitmapContainer *container;
+    uint32_t position;
+
+    container = rb_grn_bitmap_find_container(bitmap, ID_HIGH(id), &position);
+    if (!container)
+        return GRN_FALSE;
+    if (!container_delete(container, ID_LOW(id)))
+        return GRN_FALSE;
+    if (container->size == 0) {
+        container_fin(container);
+        memmove(bitmap->containers + position,
+                bitmap->containers + position + 1,
+                sizeof(RbGrnBitmapContainer) *
+                (bitmap->n_containers - position - 1));
+        bitmap->n_containers--;
+    }
+    return GRN_TRUE;
+}
+
+static uint64_t
+rb_grn_bitmap_size (RbGrnBitmap *bitmap)
+{
+    uint64_t size = 0;
+    uint32_t i;
+
+    for (i = 0; i < bitmap->n_containers; i++) {
+        size += bitmap->containers[i].size;
+    }
+    return size;
+}
+
+typedef enum {
+    SET_OPERATION_AND,
+    SET_OPERATION_OR,
+    SET_OPERATION_AND_NOT
+} RbGrnBitmapSetOperation;
+
+static void
+rb_grn_bitmap_append_result (RbGrnBitmap *result,
+                             RbGrnBitmapContainer *container)
+{
+    if (container->size == 0) {
+        container_fin(container);
+    } else {
+        *rb_grn_bitmap_append_container(result) = *container;
+    }
+}
+
+static void
+rb_grn_bitmap_set_operation (RbGrnBitmap *result,
+                             RbGrnBitmap *a,
+                             RbGrnBitmap *b,
+                             RbGrnBitmapSetOperation operation)
+{
+    uint32_t i = 0, j = 0;
+
+    while (i < a->n_containers || j < b->n_containers) {
+        RbGrnBitmapContainer *a_container = NULL;
+        RbGrnBitmapContainer *b_container = NULL;
+        RbGrnBitmapContainer container;
+
+        if (j == b->n_containers ||
+            (i < a->n_containers &&
+             a->containers[i].key < b->containers[j].key)) {
+            a_container = &(a->containers[i++]);
+        } else if (i == a->n_containers ||
+                   b->containers[j].key < a->containers[i].key) {
+            b_container = &(b->containers[j++]);
+        } else {
+            a_container = &(a->containers[i++]);
+            b_container = &(b->containers[j++]);
+        }
+
+        switch (operation) {
+        case SET_OPERATION_AND:
+            if (!a_container || !b_container)
+                continue;
+            container_and(&container, a_container, b_container);
+            break;
+        case SET_OPERATION_OR:
+            if (a_container && b_container) {
+                container_or(&container, a_container, b_container);
+            } else {
+                container_copy(&container,
+                               a_container ? a_container : b_container);
+            }
+            break;
+        case SET_OPERATION_AND_NOT:
+            if (!a_container)
+                continue;
+            if (b_container) {
+                container_and_not(&container, a_container, b_container);
+            } else {
+                container_copy(&container, a_container);
+            }
+            break;
+        default:
+            continue;
+        }
+        rb_grn_bitmap_append_result(result, &container);
+    }
+}
+
+static void
+rb_grn_bitmap_add_ruby_ids (RbGrnBitmap *bitmap, VALUE rb_ids)
+{
+    if (RB_TYPE_P(rb_ids, RUBY_T_STRING)) {
+        const char *ids = RSTRING_PTR(rb_ids);
+        long i, n_ids;
+        if ((RSTRING_LEN(rb_ids) % sizeof(uint32_t)) != 0) {
+            rb_raise(rb_eArgError,
+                     "packed IDs must be packed uint32: <%ld> bytes",
+                     RSTRING_LEN(rb_ids));
+        }
+        n_ids = RSTRING_LEN(rb_ids) / sizeof(uint32_t);
+        for (i = 0; i < n_ids; i++) {
+            uint32_t id;
+            /* The packed string may not be aligned. */
+            memcpy(&id, ids + (i * sizeof(uint32_t)), sizeof(uint32_t));
+            if (id != GRN_ID_NIL)
+                rb_grn_bitmap_add_id(bitmap, id);
+        }
+        RB_GC_GUARD(rb_ids);
+    } else if (rb_obj_is_kind_of(rb_ids, rb_cGrnBitmap)) {
+        RbGrnBitmap *other = SELF(rb_ids);
+        RbGrnBitmap result = {NULL, 0, 0};
+        rb_grn_bitmap_set_operation(&result, bitmap, other, SET_OPERATION_OR);
+        rb_grn_bitmap_clear(bitmap);
+        *bitmap = result;
+    } else {
+        VALUE rb_id_array = rb_ary_to_ary(rb_ids);
+        long i, n_ids = RARRAY_LEN(rb_id_array);
+        for (i = 0; i < n_ids; i++) {
+            grn_id id = RVAL2GRNID(RARRAY_AREF(rb_id_array, i),
+                                   NULL, NULL, rb_ids);
+            if (id != GRN_ID_NIL)
+                rb_grn_bitmap_add_id(bitmap, id);
+        }
+    }
+}
+
+/*
+ * Creates a new bitmap.
+ *
+ * @example
+ *   Groonga::Bitmap.new([1, 3, 5])
+ *   Groonga::Bitmap.new([1, 3, 5].pack("L*"))
+ *
+ * @overload initialize(ids=nil)
+ *   @param ids [::Array<Integer, Groonga::Record>, String, Groonga::Bitmap]
+ *     The initial IDs. `String` is a packed array of
+ *     native-endian unsigned 32-bit integers such as
+ *     `ids.pack("L*")`.
+ */
+static VALUE
+rb_grn_bitmap_initialize (int argc, VALUE *argv, VALUE self)
+{
+    VALUE rb_ids;
+
+    rb_scan_args(argc, argv, "01", &rb_ids);
+
+    if (!NIL_P(rb_ids))
+        rb_grn_bitmap_add_ruby_ids(SELF(self), rb_ids);
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_bitmap_initialize_copy (VALUE self, VALUE rb_source)
+{
+    RbGrnBitmap *bitmap, *source;
+    uint32_t i;
+
+    bitmap = SELF(self);
+    source = SELF(rb_source);
+    rb_grn_bitmap_clear(bitmap);
+    for (i = 0; i < source->n_containers; i++) {
+        container_copy(rb_grn_bitmap_append_container(bitmap),
+                       &(source->containers[i]));
+    }
+    return self;
+}
+
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    grn_table_cursor *cursor;
+    grn_bool use_key;
+    RbGrnBitmap *bitmap;
+} RbGrnBitmapFromTableData;
+
+static VALUE
+rb_grn_bitmap_from_table_body (VALUE user_data)
+{
+    RbGrnBitmapFromTableData *data = (RbGrnBitmapFromTableData *)user_data;
+    grn_ctx *context = data->context;
+    grn_id id;
+
+    while ((id = grn_table_cursor_next(context, data->cursor)) !=
+           GRN_ID_NIL) {
+        if (data->use_key) {
+            void *key;
+            grn_table_cursor_get_key(context, data->cursor, &key);
+            id = *((grn_id *)key);
+        }
+        rb_grn_bitmap_add_id(data->bitmap, id);
+    }
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_bitmap_from_table_ensure (VALUE user_data)
+{
+    RbGrnBitmapFromTableData *data = (RbGrnBitmapFromTableData *)user_data;
+
+    grn_table_cursor_close(data->context, data->cursor);
+
+    return Qnil;
+}
+
+/*
+ * Creates a bitmap from IDs of records in _table_.
+ *
+ * If _table_ is a result table such as the result of
+ * {Groonga::Table#select}, IDs of the original records are
+ * used. Otherwise IDs of records in _table_ are used even if
+ * _table_ uses another table as its key type.
+ *
+ * @example
+ *   books = products.select {|record| record.type == "book"}
+ *   book_ids = Groonga::Bitmap.from_table(books)
+ *
+ * @overload from_table(table)
+ *   @param table [Groonga::Table] The source table.
+ *   @return [Groonga::Bitmap] A new bitmap.
+ */
+static VALUE
+rb_grn_bitmap_s_from_table (VALUE klass, VALUE rb_table)
+{
+    grn_ctx *context = NULL;
+    RbGrnBitmapFromTableData data;
+    VALUE rb_bitmap;
+
+    data.table = RVAL2GRNTABLE(rb_table, &context);
+    data.context = context;
+    /* Only a result table has the original record IDs as its
+       keys. A persistent table keyed by another table has its own
+       record IDs. */
+    data.use_key = GRN_FALSE;
+    if (data.table->header.flags & GRN_OBJ_WITH_SUBREC) {
+        grn_obj *domain;
+        domain = grn_ctx_at(context, data.table->header.domain);
+        data.use_key = (domain && grn_obj_is_table(context, domain));
+    }
+
+    rb_bitmap = rb_class_new_instance(0, NULL, klass);
+    data.bitmap = SELF(rb_bitmap);
+
+    data.cursor = grn_table_cursor_open(context, data.table, NULL, 0, NULL, 0,
+                                        0, -1, GRN_CURSOR_ASCENDING);
+    rb_grn_context_check(context, rb_table);
+    if (!data.cursor)
+        return rb_bitmap;
+    rb_ensure(rb_grn_bitmap_from_table_body, (VALUE)&data,
+              rb_grn_bitmap_from_table_ensure, (VALUE)&data);
+
+    return rb_bitmap;
+}
+
+/*
+ * Creates a result table of _table_ that has records in the
+ * bitmap. IDs that don't exist in _table_ are ignored.
+ *
+ * The result table can be used as the input of
+ * {Groonga::Table#select}, {Groonga::Table#sort} and
+ * {Groonga::Table#group} like the result of
+ * {Groonga::Table#select}.
+ *
+ * @overload to_table(table)
+ *   @param table [Groonga::Table] The table that has records.
+ *   @return [Groonga::Hash] A new temporary result table.
+ */
+static VALUE
+rb_grn_bitmap_to_table (VALUE self, VALUE rb_table)
+{
+    grn_ctx *context = NULL;
+    grn_obj *table, *result;
+    RbGrnBitmap *bitmap;
+    uint32_t i;
+    VALUE rb_result;
+
+    bitmap = SELF(self);
+    table = RVAL2GRNTABLE(rb_table, &context);
+    result = grn_table_create(context, NULL, 0, NULL,
+                              GRN_TABLE_HASH_KEY | GRN_OBJ_WITH_SUBREC,
+                              table,
+                              NULL);
+    rb_grn_context_check(context, self);
+    if (!result) {
+        rb_raise(rb_eGrnNoMemoryAvailable,
+                 "failed to create result table: %" PRIsVALUE,
+                 rb_table);
+    }
+    rb_result = GRNTABLE2RVAL(context, result, GRN_TRUE);
+
+    for (i = 0; i < bitmap->n_containers; i++) {
+        RbGrnBitmapContainer *container = &(bitmap->containers[i]);
+        uint32_t j;
+        if (container->is_bitset) {
+            for (j = 0; j < N_BITSET_WORDS; j++) {
+                uint64_t word = container->data.words[j];
+                while (word) {
+                    int bit = popcount64((word & -word) - 1);
+                    grn_id id = ID_COMPOSE(container->key, j * 64 + bit);
+                    if (grn_table_at(context, table, id) != GRN_ID_NIL)
+                        grn_table_add(context, result, &id, sizeof(grn_id),
+                                      NULL);
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (j = 0; j < container->size; j++) {
+                grn_id id = ID_COMPOSE(container->key,
+                                       container->data.values[j]);
+                if (grn_table_at(context, table, id) != GRN_ID_NIL)
+                    grn_table_add(context, result, &id, sizeof(grn_id), NULL);
+            }
+        }
+    }
+    rb_grn_context_check(context, self);
+
+    return rb_result;
+}
+
+/*
+ * @overload add(id)
+ *   @param id [Integer, Groonga::Record] The ID to be added.
+ *   @return [Boolean] `true` if _id_ is added, `false` if it
+ *     already exists.
+ */
+static VALUE
+rb_grn_bitmap_add (VALUE self, VALUE rb_id)
+{
+    grn_id id;
+
+    id = RVAL2GRNID(rb_id, NULL, NULL, self);
+    if (id == GRN_ID_NIL)
+        return Qfalse;
+    return CBOOL2RVAL(rb_grn_bitmap_add_id(SELF(self), id));
+}
+
+/*
+ * @overload delete(id)
+ *   @param id [Integer, Groonga::Record] The ID to be deleted.
+ *   @return [Boolean] `true` if _id_ is deleted, `false` if it
+ *     doesn't exist.
+ */
+static VALUE
+rb_grn_bitmap_delete (VALUE self, VALUE rb_id)
+{
+    grn_id id;
+
+    id = RVAL2GRNID(rb_id, NULL, NULL, self);
+    return CBOOL2RVAL(rb_grn_bitmap_delete_id(SELF(self), id));
+}
+
+/*
+ * @overload include?(id)
+ *   @param id [Integer, Groonga::Record] The ID to be checked.
+ *   @return [Boolean] `true` if the bitmap has _id_.
+ */
+static VALUE
+rb_grn_bitmap_include_p (VALUE self, VALUE rb_id)
+{
+    RbGrnBitmap *bitmap;
+    RbGrnBitmapContainer *container;
+    uint32_t position;
+    grn_id id;
+
+    bitmap = SELF(self);
+    id = RVAL2GRNID(rb_id, NULL, NULL, self);
+    container = rb_grn_bitmap_find_container(bitmap, ID_HIGH(id), &position);
+    if (!container)
+        return Qfalse;
+    return CBOOL2RVAL(container_contains(container, ID_LOW(id)));
+}
+
+/*
+ * @overload size
+ *   @return [Integer] The number of IDs in the bitmap.
+ */
+static VALUE
+rb_grn_bitmap_get_size (VALUE self)
+{
+    return ULL2NUM(rb_grn_bitmap_size(SELF(self)));
+}
+
+/*
+ * @overload empty?
+ *   @return [Boolean] `true` if the bitmap has no IDs.
+ */
+static VALUE
+rb_grn_bitmap_empty_p (VALUE self)
+{
+    return CBOOL2RVAL(SELF(self)->n_containers == 0);
+}
+
+typedef struct {
+    VALUE self;
+    RbGrnBitmapContainer container;
+    grn_bool have_container;
+} RbGrnBitmapEachData;
+
+static VALUE
+rb_grn_bitmap_each_body (VALUE user_data)
+{
+    RbGrnBitmapEachData *data = (RbGrnBitmapEachData *)user_data;
+    RbGrnBitmap *bitmap;
+    RbGrnBitmapContainer *container = &(data->container);
+    uint32_t i;
+
+    bitmap = SELF(data->self);
+    for (i = 0; i < bitmap->n_containers; i++) {
+        uint32_t j;
+
+        /* Copy the container because the block may change the
+           bitmap. */
+        container_copy(container, &(bitmap->containers[i]));
+        data->have_container = GRN_TRUE;
+        if (container->is_bitset) {
+            for (j = 0; j < N_BITSET_WORDS; j++) {
+                uint64_t word = container->data.words[j];
+                while (word) {
+                    int bit = popcount64((word & -word) - 1);
+                    rb_yield(UINT2NUM(ID_COMPOSE(container->key,
+                                                 j * 64 + bit)));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (j = 0; j < container->size; j++) {
+                rb_yield(UINT2NUM(ID_COMPOSE(container->key,
+                                             container->data.values[j])));
+            }
+        }
+        data->have_container = GRN_FALSE;
+        container_fin(container);
+        if (i >= bitmap->n_containers)
+            break;
+    }
+
+    return data->self;
+}
+
+static VALUE
+rb_grn_bitmap_each_ensure (VALUE user_data)
+{
+    RbGrnBitmapEachData *data = (RbGrnBitmapEachData *)user_data;
+
+    /* The block may break, raise or throw. */
+    if (data->have_container) {
+        data->have_container = GRN_FALSE;
+        container_fin(&(data->container));
+    }
+
+    return Qnil;
+}
+
+/*
+ * Yields each ID in ascending order.
+ *
+ * @overload each {|id| ...}
+ *   @yieldparam id [Integer]
+ *   @return [Groonga::Bitmap] self.
+ */
+static VALUE
+rb_grn_bitmap_each (VALUE self)
+{
+    RbGrnBitmapEachData data;
+
+    RETURN_ENUMERATOR(self, 0, NULL);
+
+    data.self = self;
+    data.have_container = GRN_FALSE;
+    return rb_ensure(rb_grn_bitmap_each_body, (VALUE)&data,
+                     rb_grn_bitmap_each_ensure, (VALUE)&data);
+}
+
+/*
+ * @overload pack
+ *   @return [String] IDs in ascending order as a packed array of
+ *     native-endian unsigned 32-bit integers. It's the same as
+ *     `to_a.pack("L*")` but faster.
+ */
+static VALUE
+rb_grn_bitmap_pack (VALUE self)
+{
+    RbGrnBitmap *bitmap;
+    uint32_t *ids;
+    uint64_t n_ids = 0;
+    uint32_t i;
+    VALUE rb_packed;
+
+    bitmap = SELF(self);
+    rb_packed = rb_str_new(NULL, sizeof(uint32_t) * rb_grn_bitmap_size(bitmap));
+    ids = (uint32_t *)RSTRING_PTR(rb_packed);
+    for (i = 0; i < bitmap->n_containers; i++) {
+        RbGrnBitmapContainer *container = &(bitmap->containers[i]);
+        uint32_t j;
+        if (container->is_bitset) {
+            for (j = 0; j < N_BITSET_WORDS; j++) {
+                uint64_t word = container->data.words[j];
+                while (word) {
+                    int bit = popcount64((word & -word) - 1);
+                    ids[n_ids++] = ID_COMPOSE(container->key, j * 64 + bit);
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (j = 0; j < container->size; j++) {
+                ids[n_ids++] = ID_COMPOSE(container->key,
+                                          container->data.values[j]);
+            }
+        }
+    }
+    return rb_packed;
+}
+
+static VALUE
+rb_grn_bitmap_set_operation_new (VALUE self, VALUE rb_other,
+                                 RbGrnBitmapSetOperation operation)
+{
+    VALUE rb_result;
+
+    rb_result = rb_obj_alloc(rb_obj_class(self));
+    rb_grn_bitmap_set_operation(SELF(rb_result),
+                                SELF(self),
+                                SELF(rb_other),
+                                operation);
+    return rb_result;
+}
+
+static VALUE
+rb_grn_bitmap_set_operation_bang (VALUE self, VALUE rb_other,
+                                  RbGrnBitmapSetOperation operation)
+{
+    RbGrnBitmap *bitmap;
+    RbGrnBitmap result = {NULL, 0, 0};
+
+    bitmap = SELF(self);
+    rb_grn_bitmap_set_operation(&result, bitmap, SELF(rb_other), operation);
+    rb_grn_bitmap_clear(bitmap);
+    *bitmap = result;
+    return self;
+}
+
+/*
+ * @overload |(other)
+ *   @param other [Groonga::Bitmap]
+ *   @return [Groonga::Bitmap] A new bitmap that has IDs in self or
+ *     _other_.
+ */
+static VALUE
+rb_grn_bitmap_or (VALUE self, VALUE rb_other)
+{
+    return rb_grn_bitmap_set_operation_new(self, rb_other, SET_OPERATION_OR);
+}
+
+/*
+ * @overload &(other)
+ *   @param other [Groonga::Bitmap]
+ *   @return [Groonga::Bitmap] A new bitmap that has IDs in both
+ *     self and _other_.
+ */
+static VALUE
+rb_grn_bitmap_and (VALUE self, VALUE rb_other)
+{
+    return rb_grn_bitmap_set_operation_new(self, rb_other, SET_OPERATION_AND);
+}
+
+/*
+ * @overload -(other)
+ *   @param other [Groonga::Bitmap]
+ *   @return [Groonga::Bitmap] A new bitmap that has IDs in self
+ *     but not in _other_.
+ */
+static VALUE
+rb_grn_bitmap_and_not (VALUE self, VALUE rb_other)
+{
+    return rb_grn_bitmap_set_operation_new(self, rb_other,
+                                           SET_OPERATION_AND_NOT);
+}
+
+/*
+ * Adds IDs in _other_ to self.
+ *
+ * @overload union!(other)
+ *   @param other [Groonga::Bitmap]
+ *   @return [Groonga::Bitmap] self.
+ */
+static VALUE
+rb_grn_bitmap_union_bang (VALUE self, VALUE rb_other)
+{
+    return rb_grn_bitmap_set_operation_bang(self, rb_other, SET_OPERATION_OR);
+}
+
+/*
+ * Removes IDs that aren't in _other_ from self.
+ *
+ * @overload intersection!(other)
+ *   @param other [Groonga::Bitmap]
+ *   @return [Groonga::Bitmap] self.
+ */
+static VALUE
+rb_grn_bitmap_intersection_bang (VALUE self, VALUE rb_other)
+{
+    return rb_grn_bitmap_set_operation_bang(self, rb_other, SET_OPERATION_AND);
+}
+
+/*
+ * Removes IDs in _other_ from self.
+ *
+ * @overload difference!(other)
+ *   @param other [Groonga::Bitmap]
+ *   @return [Groonga::Bitmap] self.
+ */
+static VALUE
+rb_grn_bitmap_difference_bang (VALUE self, VALUE rb_other)
+{
+    return rb_grn_bitmap_set_operation_bang(self, rb_other,
+                                            SET_OPERATION_AND_NOT);
+}
+
+/*
+ * @overload ==(other)
+ *   @return [Boolean] `true` if _other_ is a bitmap that has the
+ *     same IDs.
+ */
+static VALUE
+rb_grn_bitmap_equal (VALUE self, VALUE rb_other)
+{
+    RbGrnBitmap *bitmap, *other;
+    uint32_t i;
+
+    if (!rb_obj_is_kind_of(rb_other, rb_cGrnBitmap))
+        return Qfalse;
+
+    bitmap = SELF(self);
+    other = SELF(rb_other);
+    if (bitmap->n_containers != other->n_containers)
+        return Qfalse;
+    for (i = 0; i < bitmap->n_containers; i++) {
+        RbGrnBitmapContainer *a = &(bitmap->containers[i]);
+        RbGrnBitmapContainer *b = &(other->containers[i]);
+        RbGrnBitmapContainer difference;
+        grn_bool same;
+        if (a->key != b->key || a->size != b->size)
+            return Qfalse;
+        container_and_not(&difference, a, b);
+        same = (difference.size == 0);
+        container_fin(&difference);
+        if (!same)
+            return Qfalse;
+    }
+    return Qtrue;
+}
+
+/*
+ * @overload memory_size
+ *   @return [Integer] The number of bytes used by the bitmap.
+ */
+static VALUE
+rb_grn_bitmap_get_memory_size (VALUE self)
+{
+    return SIZET2NUM(rb_grn_bitmap_memsize(SELF(self)));
+}
+
+void
+rb_grn_init_bitmap (VALUE mGrn)
+{
+    rb_cGrnBitmap = rb_define_class_under(mGrn, "Bitmap", rb_cObject);
+    rb_define_alloc_func(rb_cGrnBitmap, rb_grn_bitmap_alloc);
+    rb_include_module(rb_cGrnBitmap, rb_mEnumerable);
+
+    rb_define_singleton_method(rb_cGrnBitmap, "from_table",
+                               rb_grn_bitmap_s_from_table, 1);
+
+    rb_define_method(rb_cGrnBitmap, "initialize",
+                     rb_grn_bitmap_initialize, -1);
+    rb_define_method(rb_cGrnBitmap, "initialize_copy",
+                     rb_grn_bitmap_initialize_copy, 1);
+
+    rb_define_method(rb_cGrnBitmap, "add", rb_grn_bitmap_add, 1);
+    rb_define_method(rb_cGrnBitmap, "delete", rb_grn_bitmap_delete, 1);
+    rb_define_method(rb_cGrnBitmap, "include?", rb_grn_bitmap_include_p, 1);
+    rb_define_method(rb_cGrnBitmap, "size", rb_grn_bitmap_get_size, 0);
+    rb_define_method(rb_cGrnBitmap, "empty?", rb_grn_bitmap_empty_p, 0);
+    rb_define_method(rb_cGrnBitmap, "each", rb_grn_bitmap_each, 0);
+    rb_define_method(rb_cGrnBitmap, "pack", rb_grn_bitmap_pack, 0);
+    rb_define_method(rb_cGrnBitmap, "to_table", rb_grn_bitmap_to_table, 1);
+    rb_define_method(rb_cGrnBitmap, "memory_size",
+                     rb_grn_bitmap_get_memory_size, 0);
+
+    rb_define_method(rb_cGrnBitmap, "|", rb_grn_bitmap_or, 1);
+    rb_define_method(rb_cGrnBitmap, "&", rb_grn_bitmap_and, 1);
+    rb_define_method(rb_cGrnBitmap, "-", rb_grn_bitmap_and_not, 1);
+    rb_define_method(rb_cGrnBitmap, "union!", rb_grn_bitmap_union_bang, 1);
+    rb_define_method(rb_cGrnBitmap, "intersection!",
+                     rb_grn_bitmap_intersection_bang, 1);
+    rb_define_method(rb_cGrnBitmap, "difference!",
+                     rb_grn_bitmap_difference_bang, 1);
+    rb_define_method(rb_cGrnBitmap, "==", rb_grn_bitmap_equal, 1);
+}
@@ -43,8 +43,60 @@
 
 #define SELF(object) (RVAL2GRNCONTEXT(object))
 
+#define RB_GRN_CONTEXT_DEFERRED_OBJECTS_BATCH_SIZE 1024
+
 static VALUE cGrnContext;
 
+struct _RbGrnMemoryPool
+{
+    RbGrnMemoryPool *parent;
+    VALUE *objects;
+    long n_objects;
+    long capacity;
+};
+
+static void
+rb_grn_context_memory_pool_register (RbGrnContext *rb_grn_context,
+                                     RbGrnObject *rb_grn_object)
+{
+    RbGrnMemoryPool *memory_pool;
+
+    memory_pool = rb_grn_context->memory_pool;
+    if (!memory_pool)
+        return;
+    if (!rb_grn_object->object)
+        return;
+    if (rb_grn_object->object->header.flags & GRN_OBJ_PERSISTENT)
+        return;
+
+    if (memory_pool->n_objects == memory_pool->capacity) {
+        if (memory_pool->capacity == 0) {
+            memory_pool->capacity = 16;
+        } else {
+            memory_pool->capacity *= 2;
+        }
+        REALLOC_N(memory_pool->objects, VALUE, memory_pool->capacity);
+    }
+    memory_pool->objects[memory_pool->n_objects++] = rb_grn_object->self;
+}
+
+static void
+rb_grn_context_memory_pool_free (RbGrnMemoryPool *memory_pool)
+{
+    xfree(memory_pool->objects);
+    xfree(memory_pool);
+}
+
+static void
+rb_grn_context_free_memory_pools (RbGrnContext *rb_grn_context)
+{
+    while (rb_grn_context->memory_pool) {
+        RbGrnMemoryPool *memory_pool = rb_grn_context->memory_pool;
+        rb_grn_context->memory_pool = memory_pool->parent;
+        rb_grn_context_memory_pool_free(memory_pool);
+    }
+}
+
 void
 rb_grn_context_register_floating_object (RbGrnObject *rb_grn_object)
 {
@@ -64,7 +116,7 @@ rb_grn_context_register_floating_object (RbGrnObject *rb_grn_object)
                  NULL, NULL);
     rb_grn_object->floating = GRN_TRUE;
 
-    rb_grn_context_object_created(rb_grn_context->self, rb_grn_object->self);
+    rb_grn_context_memory_pool_register(rb_grn_context, rb_grn_object);
 }
 
 void
@@ -122,6 +174,113 @@ rb_grn_context_reset_floating_objects (RbGrnContext *rb_grn_context)
                                                        GRN_OBJ_TABLE_HASH_KEY);
 }
 
+grn_bool
+rb_grn_context_defer_object_release (RbGrnObject *rb_grn_object)
+{
+    RbGrnContext *rb_grn_context;
+    grn_obj *object;
+
+    rb_grn_context = rb_grn_object->rb_grn_context;
+    if (!rb_grn_context || !rb_grn_context->context)
+        return GRN_FALSE;
+    if (!rb_grn_context->defer_release)
+        return GRN_FALSE;
+
+    object = rb_grn_object->object;
+    if (!rb_grn_object->context || !object)
+        return GRN_FALSE;
+    if (!rb_grn_object->need_close)
+        return GRN_FALSE;
+    /* Persistent objects may be closed by Groonga itself before the
+     * queue is drained. Their unlink is cheap. */
+    if (object->header.flags & GRN_OBJ_PERSISTENT)
+        return GRN_FALSE;
+
+    if (rb_grn_object->have_finalizer) {
+        grn_user_data *user_data;
+        user_data = grn_obj_user_data(rb_grn_object->context, object);
+        if (user_data && user_data->ptr == rb_grn_object) {
+            /* The Ruby object is dead. Don't return it from
+             * rb_grn_object_to_ruby_object(). The queued object is
+             * released through its own struct. So the Groonga
+             * finalizer must not refer it. */
+            user_data->ptr = NULL;
+            grn_obj_set_finalizer(rb_grn_object->context, object, NULL);
+        }
+    }
+    rb_grn_object->self = Qnil;
+    rb_grn_object->next_deferred = rb_grn_context->deferred_objects;
+    rb_grn_context->deferred_objects = rb_grn_object;
+    rb_grn_context->n_deferred_objects++;
+
+    return GRN_TRUE;
+}
+
+static unsigned int
+rb_grn_context_release_deferred_objects_raw (RbGrnContext *rb_grn_context)
+{
+    unsigned int n_released_objects = 0;
+
+    while (rb_grn_context->deferred_objects) {
+        RbGrnObject *rb_grn_object;
+
+        rb_grn_object = rb_grn_context->deferred_objects;
+        rb_grn_context->deferred_objects = rb_grn_object->next_deferred;
+        rb_grn_context->n_deferred_objects--;
+        rb_grn_object->next_deferred = NULL;
+        if (rb_grn_object->floating) {
+            rb_grn_context_unregister_floating_object(rb_grn_object);
+        }
+        rb_grn_object_release_deferred(rb_grn_object, GRN_TRUE);
+        n_released_objects++;
+    }
+
+    return n_released_objects;
+}
+
+/*
+ * It's called before a new Ruby object is bound to _object_. If a
+ * dead Ruby object for _object_ is queued, it's released without
+ * closing _object_. The new Ruby object owns _object_ instead.
+ */
+void
+rb_grn_context_release_deferred_object (grn_ctx *context, grn_obj *object)
+{
+    RbGrnContext *rb_grn_context;
+    RbGrnObject **deferred_object;
+
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    if (!rb_grn_context)
+        return;
+    /* It's called for each new Ruby object. Avoid scanning the
+     * queue when nothing can be queued for _object_. */
+    if (!rb_grn_context->defer_release)
+        return;
+    if (!rb_grn_context->deferred_objects)
+        return;
+    if (object->header.flags & GRN_OBJ_PERSISTENT)
+        return;
+
+    deferred_object = &(rb_grn_context->deferred_objects);
+    while (*deferred_object) {
+        RbGrnObject *rb_grn_object = *deferred_object;
+
+        if (rb_grn_object->object != object) {
+            deferred_object = &(rb_grn_object->next_deferred);
+            continue;
+        }
+
+        *deferred_object = rb_grn_object->next_deferred;
+        rb_grn_context->n_deferred_objects--;
+        rb_grn_object->next_deferred = NULL;
+        if (rb_grn_object->floating) {
+            rb_grn_context_unregister_floating_object(rb_grn_object);
+        }
+        rb_grn_object_release_deferred(rb_grn_object, GRN_FALSE);
+        break;
+    }
+}
+
 void
 rb_grn_context_mark_grn_id (grn_ctx *context, grn_id id)
 {
@@ -167,7 +326,9 @@ rb_grn_context_fin (RbGrnContext *rb_grn_context)
 
     debug("context-fin: %p\n", context);
 
+    rb_grn_context_release_deferred_objects_raw(rb_grn_context);
     rb_grn_context_close_floating_objects(rb_grn_context);
+    rb_grn_context_free_memory_pools(rb_grn_context);
 
     if (context && context->stat != GRN_CTX_FIN && !rb_grn_exited) {
         if (!(context->flags & GRN_CTX_PER_DB)) {
@@ -189,13 +350,28 @@ rb_grn_context_free (void *pointer)
     debug("context-free: %p\n", rb_grn_context);
     rb_grn_context_fin(rb_grn_context);
     debug("context-free: %p: done\n", rb_grn_context);
+    rb_grn_metrics_free(rb_grn_context->metrics);
     xfree(rb_grn_context);
 }
 
+static void
+rb_grn_context_mark (void *pointer)
+{
+    RbGrnContext *rb_grn_context = pointer;
+    RbGrnMemoryPool *memory_pool;
+
+    for (memory_pool = rb_grn_context->memory_pool;
+         memory_pool;
+         memory_pool = memory_pool->parent) {
+        rb_gc_mark_locations(memory_pool->objects,
+                             memory_pool->objects + memory_pool->n_objects);
+    }
+}
+
 static rb_data_type_t data_type = {
     "Groonga::Context",
     {
-        NULL,
+        rb_grn_context_mark,
         rb_grn_context_free,
         NULL,
     },
@@ -335,6 +511,99 @@ rb_grn_context_rb_string_new (grn_ctx *context, const char *string, long length)
                           rb_grn_encoding_to_ruby_encoding(context->encoding));
 }
 
+VALUE
+rb_grn_context_rb_interned_string_new (grn_ctx *context,
+                                       const char *string,
+                                       long length)
+{
+    rb_encoding *encoding;
+
+    if (length < 0)
+        length = strlen(string);
+    encoding = rb_grn_encoding_to_ruby_encoding(context->encoding);
+#ifdef HAVE_RB_ENC_INTERNED_STR
+    return rb_enc_interned_str(string, length, encoding);
+#else
+    return rb_funcall(rb_enc_str_new(string, length, encoding),
+                      rb_intern("-@"), 0);
+#endif
+}
+
+unsigned int
+rb_grn_context_get_value_mode (grn_ctx *context)
+{
+    RbGrnContext *rb_grn_context;
+
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    if (!rb_grn_context)
+        return 0;
+
+    return rb_grn_context->value_mode;
+}
+
+VALUE
+rb_grn_context_get_record_identity_map (grn_ctx *context)
+{
+    RbGrnContext *rb_grn_context;
+
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    if (!rb_grn_context)
+        return Qnil;
+
+    return rb_grn_context->record_identity_map;
+}
+
+grn_bool
+rb_grn_context_is_recording_changes (grn_ctx *context)
+{
+    RbGrnContext *rb_grn_context;
+
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    if (!rb_grn_context)
+        return GRN_FALSE;
+
+    return !NIL_P(rb_grn_context->change_log);
+}
+
+void
+rb_grn_context_record_change (grn_ctx *context,
+                              RbGrnChangeType type,
+                              grn_obj *object,
+                              grn_id id)
+{
+    RbGrnContext *rb_grn_context;
+    grn_id table_id;
+    grn_id column_id;
+
+    if (!rb_grn_context_is_recording_changes(context))
+        return;
+    if (!object)
+        return;
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    /* Changes of temporary tables such as search results aren't
+     * recorded. */
+    if (!(object->header.flags & GRN_OBJ_PERSISTENT))
+        return;
+
+    if (grn_obj_is_table(context, object)) {
+        table_id = grn_obj_id(context, object);
+        column_id = GRN_ID_NIL;
+    } else {
+        table_id = object->header.domain;
+        column_id = grn_obj_id(context, object);
+    }
+
+    {
+        ID id_record;
+        CONST_ID(id_record, "record");
+        rb_funcall(rb_grn_context->change_log, id_record, 4,
+                   INT2NUM(type),
+                   UINT2NUM(table_id),
+                   UINT2NUM(id),
+                   UINT2NUM(column_id));
+    }
+}
+
 VALUE
 rb_grn_context_rb_string_encode (grn_ctx *context, VALUE rb_string)
 {
@@ -494,6 +763,14 @@ rb_grn_context_initialize (int argc, VALUE *argv, VALUE self)
 
     GRN_CTX_USER_DATA(context)->ptr = rb_grn_context;
     rb_grn_context->floating_objects = NULL;
+    rb_grn_context->metrics = NULL;
+    rb_grn_context->memory_pool = NULL;
+    rb_grn_context->defer_release = GRN_FALSE;
+    rb_grn_context->deferred_objects = NULL;
+    rb_grn_context->n_deferred_objects = 0;
+    rb_grn_context->value_mode = 0;
+    rb_grn_context->change_log = Qnil;
+    rb_grn_context->record_identity_map = Qnil;
     rb_grn_context_reset_floating_objects(rb_grn_context);
     grn_ctx_set_finalizer(context, rb_grn_context_finalizer);
 
@@ -504,8 +781,6 @@ rb_grn_context_initialize (int argc, VALUE *argv, VALUE self)
         GRN_CTX_SET_ENCODING(context, encoding);
     }
 
-    rb_iv_set(self, "@memory_pools", rb_ary_new());
-
     debug("context new: %p\n", context);
 
     return Qnil;
@@ -1048,12 +1323,589 @@ rb_grn_context_is_opened (VALUE self, VALUE rb_id)
     return CBOOL2RVAL(is_opened);
 }
 
+/*
+ * Checks whether a temporary object such as a result table or an
+ * accessor in the context refers to the object with the ID as its
+ * domain or range.
+ *
+ * A temporary object keeps its domain and range. So the object
+ * with the ID must not be closed while it returns `true`.
+ *
+ * @overload referred_by_temporary_object?(id)
+ *   @param id [Integer] The ID to be checked.
+ *   @return [Boolean] `true` if a temporary object refers to the
+ *     object with the `id`, `false` otherwise.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_is_referred_by_temporary_object (VALUE self, VALUE rb_id)
+{
+    RbGrnContext *rb_grn_context;
+    grn_ctx *context;
+    grn_hash *floating_objects;
+    grn_id id;
+    grn_bool referred = GRN_FALSE;
+
+    context = SELF(self);
+    rb_grn_context = rb_grn_context_get_struct(self);
+    id = NUM2UINT(rb_id);
+    floating_objects = rb_grn_context->floating_objects;
+    if (!floating_objects)
+        return Qfalse;
+
+    GRN_HASH_EACH_BEGIN(context, floating_objects, cursor, floating_id) {
+        void *key;
+        RbGrnObject *floating_object;
+
+        grn_hash_cursor_get_key(context, cursor, &key);
+        floating_object = *((RbGrnObject **)key);
+        if (floating_object->domain_id == id ||
+            floating_object->range_id == id) {
+            referred = GRN_TRUE;
+            break;
+        }
+    } GRN_HASH_EACH_END(context, cursor);
+
+    return CBOOL2RVAL(referred);
+}
+
+/*
+ * Returns metrics collected in the context. See
+ * {Groonga::Metrics.snapshot} for the format.
+ *
+ * @overload metrics
+ *   @return [::Hash{Symbol => ::Hash}] The metrics of the context.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_get_metrics (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    return rb_grn_metrics_to_ruby_object(rb_grn_context->metrics);
+}
+
+/*
+ * Clears metrics collected in the context.
+ *
+ * @overload reset_metrics
+ *   @return [void]
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_reset_metrics (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    rb_grn_metrics_reset(rb_grn_context->metrics);
+
+    return Qnil;
+}
+
+static VALUE rb_grn_context_pop_memory_pool (VALUE self);
+
+/*
+ * Pushes a new memory pool to the context. Temporary objects that
+ * are created between pushing a new memory pool and popping the
+ * new memory pool are closed automatically when popping the new
+ * memory pool.
+ *
+ * It is useful for request and response style applications. These
+ * style applications can close temporary objects between a request
+ * and resopnse pair. There are some merits for closing temporary
+ * objects explicilty rather than closing implicitly by GC:
+ *
+ *   * Less memory consumption
+ *   * Faster
+ *
+ * The "less memory consumption" merit is caused by temporary
+ * objects are closed each request and response pair. The max
+ * memory consumption in these applications is the same as the max
+ * memory consumption in a request and response pair. If temporary
+ * objects are closed by GC, the max memory consumption in these
+ * applications is the same as the max memory consumption between
+ * the current GC and the next GC. These applications process many
+ * request and response pairs during two GCs.
+ *
+ * The "faster" merit is caused by reducing GC. You can reduce GC,
+ * your application run faster because GC is a heavy process. You
+ * can reduce GC because memory consumption is reduced.
+ *
+ * Temporary objects are registered to the memory pool without
+ * calling any Ruby methods. They are closed in reverse creation
+ * order when the memory pool is popped.
+ *
+ * You can nest {#push_memory_pool} and {#pop_memory_pool} pair.
+ *
+ * @example Pushes a new memory pool with block
+ *   adults = nil
+ *   context.push_memory_pool do
+ *     users = context["Users"]
+ *     adults = users.select do |user|
+ *       user.age >= 20
+ *     end
+ *     p adults.temporary? # => true
+ *     p adults.closed?    # => false
+ *   end
+ *   p adults.closed?      # => true
+ *
+ * @example Pushes a new memory pool without block
+ *   adults = nil
+ *   context.push_memory_pool
+ *   users = context["Users"]
+ *   adults = users.select do |user|
+ *     user.age >= 20
+ *   end
+ *   p adults.temporary? # => true
+ *   p adults.closed?    # => false
+ *   context.pop_memory_pool
+ *   p adults.closed?    # => true
+ *
+ * @example Nesting push and pop pair
+ *   adults = nil
+ *   context.push_memory_pool do
+ *     users = context["Users"]
+ *     adults = users.select do |user|
+ *       user.age >= 20
+ *     end
+ *     grouped_adults = nil
+ *     context.push_memory_pool do
+ *       grouped_adults = adults.group(["hobby"])
+ *       p grouped_adults.temporary? # => true
+ *       p grouped_adults.closed?    # => false
+ *     end
+ *     p grouped_adults.closed?      # => true
+ *     p adults.temporary?           # => true
+ *     p adults.closed?              # => false
+ *   end
+ *   p adults.closed?                # => true
+ *
+ * @overload push_memory_pool
+ *   Pushes a new memory pool to the context. You need to pop the
+ *   memory pool explicitly by yourself.
+ *
+ *   @return [void]
+ *
+ * @overload push_memory_pool {}
+ *   Closes temporary objects created in the given block
+ *   automatically.
+ *
+ *   @yield []
+ *     Yields the block. Temporary objects created in the block
+ *     are closed automatically when the block is exited.
+ *   @yieldreturn [Object] It is the return value of this
+ *     method call.
+ *   @return [Object] The value returned by the block.
+ *
+ * @since 3.0.5
+ */
+static VALUE
+rb_grn_context_push_memory_pool (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+    RbGrnMemoryPool *memory_pool;
+
+    memory_pool = ALLOC(RbGrnMemoryPool);
+    memory_pool->parent = rb_grn_context->memory_pool;
+    memory_pool->objects = NULL;
+    memory_pool->n_objects = 0;
+    memory_pool->capacity = 0;
+    rb_grn_context->memory_pool = memory_pool;
+
+    if (!rb_block_given_p())
+        return Qnil;
+
+    return rb_ensure(rb_yield, Qnil, rb_grn_context_pop_memory_pool, self);
+}
+
+/*
+ * Pops the pushed memory pool.
+ *
+ * @overload pop_memory_pool
+ *   @return [void]
+ *
+ * @see push_memory_pool
+ *
+ * @since 3.0.5
+ */
+static VALUE
+rb_grn_context_pop_memory_pool (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+    RbGrnMemoryPool *memory_pool;
+    long i;
+
+    memory_pool = rb_grn_context->memory_pool;
+    if (!memory_pool) {
+        rb_raise(rb_eGrnError, "no memory pool is pushed: %" PRIsVALUE, self);
+    }
+    rb_grn_context->memory_pool = memory_pool->parent;
+
+    for (i = memory_pool->n_objects - 1; i >= 0; i--) {
+        RbGrnObject *rb_grn_object;
+
+        rb_grn_object = RTYPEDDATA_DATA(memory_pool->objects[i]);
+        if (!rb_grn_object)
+            continue;
+        if (!(rb_grn_object->context && rb_grn_object->object))
+            continue;
+        rb_grn_object_close_raw(rb_grn_object);
+    }
+    rb_grn_context_memory_pool_free(memory_pool);
+    rb_grn_context_release_deferred_objects_raw(rb_grn_context);
+
+    return Qnil;
+}
+
 void
 rb_grn_context_object_created (VALUE rb_context, VALUE rb_object)
 {
-    ID id_object_created;
-    CONST_ID(id_object_created, "object_created");
-    rb_funcall(rb_context, id_object_created, 1, rb_object);
+    RbGrnContext *rb_grn_context;
+    RbGrnObject *rb_grn_object;
+
+    if (NIL_P(rb_context))
+        return;
+
+    rb_grn_context = rb_grn_context_get_struct(rb_context);
+    if (!rb_grn_context)
+        return;
+
+    if (rb_grn_context->n_deferred_objects >=
+        RB_GRN_CONTEXT_DEFERRED_OBJECTS_BATCH_SIZE) {
+        rb_grn_context_release_deferred_objects_raw(rb_grn_context);
+    }
+
+    if (!rb_grn_context->memory_pool)
+        return;
+
+    rb_grn_object = RTYPEDDATA_DATA(rb_object);
+    if (!rb_grn_object)
+        return;
+
+    rb_grn_context_memory_pool_register(rb_grn_context, rb_grn_object);
+}
+
+/*
+ * Returns whether objects collected by GC are released later in a
+ * batch or not.
+ *
+ * @overload defer_release?
+ *   @return [Boolean] `true` if release is deferred.
+ *
+ * @see #defer_release=
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_is_defer_release (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    return CBOOL2RVAL(rb_grn_context->defer_release);
+}
+
+/*
+ * Sets whether temporary objects such as result tables, cursors,
+ * accessors and expressions collected by GC are released later in
+ * a batch or not.
+ *
+ * Releasing many temporary objects in GC makes GC pause
+ * long. If release is deferred, GC only queues collected objects
+ * to the context. Queued objects are released when
+ * {#pop_memory_pool} is called, when many objects are queued and a
+ * new object is created, when {#release_deferred_objects} is called
+ * and when the context is closed.
+ *
+ * Persistent objects such as tables and columns in the database
+ * are always released in GC.
+ *
+ * @example Release queued objects in a background thread
+ *   context.defer_release = true
+ *   Thread.new do
+ *     loop do
+ *       sleep(1)
+ *       context.release_deferred_objects
+ *     end
+ *   end
+ *
+ * @overload defer_release=(defer)
+ *   @param defer [Boolean] `true` to defer release.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_set_defer_release (VALUE self, VALUE rb_defer)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    rb_grn_context->defer_release = RVAL2CBOOL(rb_defer);
+    if (!rb_grn_context->defer_release) {
+        rb_grn_context_release_deferred_objects_raw(rb_grn_context);
+    }
+
+    return rb_defer;
+}
+
+/*
+ * Releases objects queued by GC. See {#defer_release=}.
+ *
+ * @overload release_deferred_objects
+ *   @return [Integer] The number of released objects.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_release_deferred_objects (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+    unsigned int n_released_objects;
+
+    n_released_objects =
+        rb_grn_context_release_deferred_objects_raw(rb_grn_context);
+
+    return UINT2NUM(n_released_objects);
+}
+
+/*
+ * @overload n_deferred_objects
+ *   @return [Integer] The number of objects queued by GC that
+ *     aren't released yet. See {#defer_release=}.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_get_n_deferred_objects (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    return UINT2NUM(rb_grn_context->n_deferred_objects);
+}
+
+static VALUE
+rb_grn_context_get_value_mode_flag (VALUE self, RbGrnValueMode flag)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    return CBOOL2RVAL(rb_grn_context->value_mode & flag);
+}
+
+static VALUE
+rb_grn_context_set_value_mode_flag (VALUE self, RbGrnValueMode flag,
+                                    VALUE rb_enabled)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    if (RVAL2CBOOL(rb_enabled)) {
+        rb_grn_context->value_mode |= flag;
+    } else {
+        rb_grn_context->value_mode &= ~flag;
+    }
+
+    return rb_enabled;
+}
+
+/*
+ * @overload raw_time?
+ *   @return [Boolean] `true` if `Time` values are returned as
+ *     `Integer` microseconds since the epoch.
+ *
+ * @see #raw_time=
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_is_raw_time (VALUE self)
+{
+    return rb_grn_context_get_value_mode_flag(self,
+                                              RB_GRN_VALUE_MODE_RAW_TIME);
+}
+
+/*
+ * Sets whether `Time` values read by {Groonga::Column#[]},
+ * {Groonga::Record#[]}, cursors and so on are returned as `Integer`
+ * microseconds since the epoch instead of `::Time`. It's faster
+ * because no `::Time` is created.
+ *
+ * Note that an `Integer` set to a `Time` column is still treated
+ * as seconds.
+ *
+ * @overload raw_time=(raw)
+ *   @param raw [Boolean] `true` to return raw `Time` values.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_set_raw_time (VALUE self, VALUE rb_raw)
+{
+    return rb_grn_context_set_value_mode_flag(self,
+                                              RB_GRN_VALUE_MODE_RAW_TIME,
+                                              rb_raw);
+}
+
+/*
+ * @overload interned_text?
+ *   @return [Boolean] `true` if text values are returned as frozen
+ *     deduplicated `String`.
+ *
+ * @see #interned_text=
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_is_interned_text (VALUE self)
+{
+    return rb_grn_context_get_value_mode_flag(self,
+                                              RB_GRN_VALUE_MODE_INTERNED_TEXT);
+}
+
+/*
+ * Sets whether `ShortText`, `Text` and `LongText` values and keys
+ * are returned as frozen deduplicated `String`. The same value
+ * returns the same `String` object. It reduces allocations for
+ * low-cardinality values such as category names.
+ *
+ * Don't use it for high-cardinality values. Deduplicated strings
+ * are kept until they aren't referenced.
+ *
+ * @overload interned_text=(interned)
+ *   @param interned [Boolean] `true` to return interned strings.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_set_interned_text (VALUE self, VALUE rb_interned)
+{
+    return rb_grn_context_set_value_mode_flag(self,
+                                              RB_GRN_VALUE_MODE_INTERNED_TEXT,
+                                              rb_interned);
+}
+
+/*
+ * @overload raw_reference?
+ *   @return [Boolean] `true` if references are returned as record
+ *     IDs.
+ *
+ * @see #raw_reference=
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_is_raw_reference (VALUE self)
+{
+    return rb_grn_context_get_value_mode_flag(self,
+                                              RB_GRN_VALUE_MODE_RAW_REFERENCE);
+}
+
+/*
+ * Sets whether values of reference columns are returned as
+ * `Integer` record IDs instead of {Groonga::Record}.
+ *
+ * @overload raw_reference=(raw)
+ *   @param raw [Boolean] `true` to return record IDs.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_set_raw_reference (VALUE self, VALUE rb_raw)
+{
+    return rb_grn_context_set_value_mode_flag(self,
+                                              RB_GRN_VALUE_MODE_RAW_REFERENCE,
+                                              rb_raw);
+}
+
+/*
+ * @overload change_log
+ *   @return [Groonga::ChangeLog, nil] The change log that records
+ *     changes made through the context. `nil` if changes aren't
+ *     recorded.
+ *
+ * @see #change_log=
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_get_change_log (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    return rb_grn_context->change_log;
+}
+
+/*
+ * Sets the change log that records changes of persistent tables and
+ * columns made through the context. Adding records, deleting records,
+ * setting values, incrementing and decrementing values and
+ * {Groonga::Table#load_arrow} are recorded.
+ *
+ * Changes aren't recorded by default. There is no overhead when no
+ * change log is set.
+ *
+ * @example Record changes into a file
+ *   change_log = Groonga::ChangeLog.new(:path => "db/changes.log")
+ *   context.change_log = change_log
+ *   users.add("mori", :age => 46)
+ *
+ * @overload change_log=(change_log)
+ *   @param change_log [Groonga::ChangeLog, nil] The change log. `nil`
+ *     stops recording.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_set_change_log (VALUE self, VALUE rb_change_log)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    rb_grn_context->change_log = rb_change_log;
+    /* For GC. */
+    rb_iv_set(self, "@change_log", rb_change_log);
+
+    return rb_change_log;
+}
+
+/*
+ * @overload record_identity_map
+ *   @return [::Hash, nil] The identity map of records. `nil` if
+ *     it's disabled.
+ *
+ * @see #with_record_identity_map
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_get_record_identity_map_method (VALUE self)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    return rb_grn_context->record_identity_map;
+}
+
+/*
+ * Sets the identity map of records. Use
+ * {#with_record_identity_map} instead of this.
+ *
+ * @overload record_identity_map=(map)
+ *   @param map [::Hash, nil] The identity map. It must compare keys
+ *     by identity. `nil` disables it.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_context_set_record_identity_map (VALUE self, VALUE rb_map)
+{
+    RbGrnContext *rb_grn_context = rb_grn_context_get_struct(self);
+
+    if (!NIL_P(rb_map)) {
+        Check_Type(rb_map, T_HASH);
+    }
+    rb_grn_context->record_identity_map = rb_map;
+    /* For GC. */
+    rb_iv_set(self, "@record_identity_map", rb_map);
+
+    return rb_map;
 }
 
 void
@@ -1115,4 +1967,47 @@ rb_grn_init_context (VALUE mGrn)
     rb_define_method(cGrnContext, "receive", rb_grn_context_receive, 0);
 
     rb_define_method(cGrnContext, "opened?", rb_grn_context_is_opened, 1);
+    rb_define_method(cGrnContext, "referred_by_temporary_object?",
+                     rb_grn_context_is_referred_by_temporary_object, 1);
+
+    rb_define_method(cGrnContext, "push_memory_pool",
+                     rb_grn_context_push_memory_pool, 0);
+    rb_define_method(cGrnContext, "pop_memory_pool",
+                     rb_grn_context_pop_memory_pool, 0);
+
+    rb_define_method(cGrnContext, "metrics", rb_grn_context_get_metrics, 0);
+    rb_define_method(cGrnContext, "reset_metrics",
+                     rb_grn_context_reset_metrics, 0);
+
+    rb_define_method(cGrnContext, "defer_release?",
+                     rb_grn_context_is_defer_release, 0);
+    rb_define_method(cGrnContext, "defer_release=",
+                     rb_grn_context_set_defer_release, 1);
+    rb_define_method(cGrnContext, "release_deferred_objects",
+                     rb_grn_context_release_deferred_objects, 0);
+    rb_define_method(cGrnContext, "n_deferred_objects",
+                     rb_grn_context_get_n_deferred_objects, 0);
+
+    rb_define_method(cGrnContext, "raw_time?",
+                     rb_grn_context_is_raw_time, 0);
+    rb_define_method(cGrnContext, "raw_time=",
+                     rb_grn_context_set_raw_time, 1);
+    rb_define_method(cGrnContext, "interned_text?",
+                     rb_grn_context_is_interned_text, 0);
+    rb_define_method(cGrnContext, "interned_text=",
+                     rb_grn_context_set_interned_text, 1);
+    rb_define_method(cGrnContext, "raw_reference?",
+                     rb_grn_context_is_raw_reference, 0);
+    rb_define_method(cGrnContext, "raw_reference=",
+                     rb_grn_context_set_raw_reference, 1);
+
+    rb_define_method(cGrnContext, "change_log",
+                     rb_grn_context_get_change_log, 0);
+    rb_define_method(cGrnContext, "change_log=",
+                     rb_grn_context_set_change_log, 1);
+
+    rb_define_method(cGrnContext, "record_identity_map",
+                     rb_grn_context_get_record_identity_map_method, 0);
+    rb_define_method(cGrnContext, "record_identity_map=",
+                     rb_grn_context_set_record_identity_map, 1);
 }
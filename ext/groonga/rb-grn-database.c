@@ -565,6 +565,7 @@ rb_grn_database_defrag (int argc, VALUE *argv, VALUE self)
     int n_segments;
     VALUE options, rb_threshold;
     int threshold = 0;
+    uint64_t metrics_start;
 
     rb_scan_args(argc, argv, "01", &options);
     rb_grn_scan_options(options,
@@ -576,7 +577,9 @@ rb_grn_database_defrag (int argc, VALUE *argv, VALUE self)
 
     rb_grn_database_deconstruct(SELF(self), &database, &context,
                                 NULL, NULL, NULL, NULL);
+    metrics_start = RB_GRN_METRICS_START();
     n_segments = grn_obj_defrag(context, database, threshold);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_DEFRAG, metrics_start);
     rb_grn_context_check(context, self);
 
     return INT2NUM(n_segments);
@@ -713,11 +716,14 @@ rb_grn_database_reindex (VALUE self)
     grn_rc rc;
     grn_ctx *context;
     grn_obj *database;
+    uint64_t metrics_start;
 
     rb_grn_database_deconstruct(SELF(self), &database, &context,
                                 NULL, NULL, NULL, NULL);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_reindex(context, database);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_REINDEX, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
 
@@ -214,6 +214,88 @@ rb_grn_encoding_s_set_default (VALUE self, VALUE rb_encoding)
     return rb_encoding;
 }
 
+/*
+ * Removes invalid byte sequences from _string_.
+ *
+ * Validity of the whole string is checked natively at first. The
+ * result of the check is cached in _string_ by Ruby. If _string_
+ * is valid, _string_ itself is returned without copying. Otherwise,
+ * a new string that has only valid characters is returned.
+ *
+ * @example Report invalid bytes
+ *   sanitized = Groonga::Encoding.sanitize("a\xffb") do |offset, length|
+ *     p [offset, length] # => [1, 1]
+ *   end
+ *   p sanitized # => "ab"
+ *
+ * @overload sanitize(string)
+ *   @param string [String] The string to be sanitized.
+ *   @yield [offset, length] Yields each invalid byte sequence.
+ *   @yieldparam offset [Integer] The byte offset of the invalid byte
+ *     sequence in _string_.
+ *   @yieldparam length [Integer] The number of bytes of the invalid
+ *     byte sequence.
+ *   @return [String] _string_ itself if it's valid, a sanitized
+ *     new string otherwise.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_encoding_s_sanitize (VALUE self, VALUE rb_string)
+{
+    rb_encoding *encoding;
+    VALUE rb_frozen_string;
+    VALUE rb_sanitized;
+    long offset, valid_offset, size;
+    int min_length;
+
+    rb_string = rb_grn_convert_to_string(rb_string);
+    if (rb_enc_str_coderange(rb_string) != ENC_CODERANGE_BROKEN)
+        return rb_string;
+
+    /* The block can't change the string that is being scanned. */
+    rb_frozen_string = rb_str_new_frozen(rb_string);
+    encoding = rb_enc_get(rb_frozen_string);
+    min_length = rb_enc_mbminlen(encoding);
+    size = RSTRING_LEN(rb_frozen_string);
+    rb_sanitized = rb_enc_str_new(NULL, 0, encoding);
+    offset = 0;
+    valid_offset = 0;
+    while (offset < size) {
+        const char *start, *current, *end;
+        int length;
+        int invalid_length;
+
+        start = RSTRING_PTR(rb_frozen_string);
+        current = start + offset;
+        end = start + size;
+        length = rb_enc_precise_mbclen(current, end, encoding);
+        if (MBCLEN_CHARFOUND_P(length)) {
+            offset += MBCLEN_CHARFOUND_LEN(length);
+            continue;
+        }
+
+        if (min_length <= end - current) {
+            invalid_length = min_length;
+        } else {
+            invalid_length = (int)(end - current);
+        }
+        rb_str_buf_cat(rb_sanitized,
+                       start + valid_offset,
+                       offset - valid_offset);
+        if (rb_block_given_p()) {
+            rb_yield_values(2, LONG2NUM(offset), INT2NUM(invalid_length));
+        }
+        offset += invalid_length;
+        valid_offset = offset;
+    }
+    rb_str_buf_cat(rb_sanitized,
+                   RSTRING_PTR(rb_frozen_string) + valid_offset,
+                   size - valid_offset);
+
+    return rb_sanitized;
+}
+
 void
 rb_grn_init_encoding (VALUE mGrn)
 {
@@ -223,6 +305,8 @@ rb_grn_init_encoding (VALUE mGrn)
                                rb_grn_encoding_s_get_default, 0);
     rb_define_singleton_method(mGrnEncoding, "default=",
                                rb_grn_encoding_s_set_default, 1);
+    rb_define_singleton_method(mGrnEncoding, "sanitize",
+                               rb_grn_encoding_s_sanitize, 1);
 
 #define DEFINE_ENCODING(name, value)                                    \
     RB_GRN_ENCODING_ ## name = RB_GRN_INTERN(value);                    \
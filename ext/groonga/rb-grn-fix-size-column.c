@@ -43,6 +43,7 @@ rb_grn_fix_size_column_array_reference (VALUE self, VALUE rb_id)
     grn_obj *fix_size_column;
     grn_obj *range;
     grn_obj *value;
+    uint64_t metrics_start;
 
     rb_grn_column_deconstruct(SELF(self), &fix_size_column, &context,
                               NULL, NULL,
@@ -50,7 +51,9 @@ rb_grn_fix_size_column_array_reference (VALUE self, VALUE rb_id)
 
     id = NUM2UINT(rb_id);
     GRN_BULK_REWIND(value);
+    metrics_start = RB_GRN_METRICS_START();
     grn_obj_get_value(context, fix_size_column, id, value);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_READ, metrics_start);
     rb_grn_context_check(context, self);
 
     return GRNVALUE2RVAL(context, value, range, self);
@@ -73,6 +76,7 @@ rb_grn_fix_size_column_array_set (VALUE self, VALUE rb_id, VALUE rb_value)
     grn_obj *value;
     grn_rc rc;
     grn_id id;
+    uint64_t metrics_start;
 
     rb_grn_column_deconstruct(SELF(self), &column, &context,
                               &domain_id, &domain,
@@ -81,9 +85,12 @@ rb_grn_fix_size_column_array_set (VALUE self, VALUE rb_id, VALUE rb_value)
     id = NUM2UINT(rb_id);
     RVAL2GRNVALUE(rb_value, context, value, range_id, range);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_set_value(context, column, id, value, GRN_OBJ_SET);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_WRITE, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_SET, column, id);
 
     return Qnil;
 }
@@ -97,6 +104,7 @@ rb_grn_fix_size_column_integer_set (int argc, VALUE *argv, VALUE self, int flags
     grn_rc rc;
     grn_id id;
     VALUE rb_id, rb_delta;
+    uint64_t metrics_start;
 
     rb_scan_args(argc, argv, "11", &rb_id, &rb_delta);
 
@@ -111,9 +119,12 @@ rb_grn_fix_size_column_integer_set (int argc, VALUE *argv, VALUE self, int flags
     GRN_BULK_REWIND(value);
     RVAL2GRNBULK(rb_delta, context, value);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_set_value(context, column, id, value, flags);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_WRITE, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_INCREMENT, column, id);
 
     return Qnil;
 }
@@ -142,6 +153,243 @@ rb_grn_fix_size_column_decrement (int argc, VALUE *argv, VALUE self)
     return rb_grn_fix_size_column_integer_set(argc, argv, self, GRN_OBJ_DECR);
 }
 
+typedef struct {
+    grn_id id;
+    union {
+        int64_t integer;
+        double floating_point;
+    } delta;
+} RbGrnFixSizeColumnUpdate;
+
+static int
+rb_grn_fix_size_column_update_compare (const void *a, const void *b)
+{
+    grn_id id_a = ((const RbGrnFixSizeColumnUpdate *)a)->id;
+    grn_id id_b = ((const RbGrnFixSizeColumnUpdate *)b)->id;
+
+    if (id_a < id_b)
+        return -1;
+    if (id_a > id_b)
+        return 1;
+    return 0;
+}
+
+static grn_id
+rb_grn_fix_size_column_fetch_id (VALUE rb_ids, long i)
+{
+    if (RB_TYPE_P(rb_ids, T_STRING)) {
+        grn_id id;
+        memcpy(&id, RSTRING_PTR(rb_ids) + sizeof(grn_id) * i, sizeof(grn_id));
+        return id;
+    } else {
+        return NUM2UINT(RARRAY_AREF(rb_ids, i));
+    }
+}
+
+/*
+ * Increases values of many records in one call. Updates are
+ * sorted by record ID and deltas for the same ID are merged before
+ * they are applied. All updates are applied while the column is
+ * locked.
+ *
+ * @example Apply queued click counts
+ *   clicks = Groonga["Entries.n_clicks"]
+ *   clicks.increment_many!([3, 1, 3], [1, 5, 2])
+ *   # Entries 1 and 3 are increased by 5 and 3.
+ *
+ * @example Use packed IDs and deltas
+ *   clicks.increment_many!(ids.pack("L*"), deltas.pack("q*"))
+ *
+ * @overload increment_many!(ids, deltas=nil, options={})
+ *   @param ids [::Array<Integer>, String] The record IDs. A String
+ *     is packed record IDs (`"L*"`).
+ *   @param deltas [::Array<Numeric>, String, Numeric, nil] The
+ *     deltas for `ids`. A String is packed deltas: `"q*"` for an
+ *     integer column and `"d*"` for a float column. A Numeric is
+ *     used for all records. `nil` means `1`.
+ *   @param options [::Hash] The name and value pairs.
+ *   @option options [Boolean] :lock (true) Whether the column is
+ *     locked while updates are applied.
+ *   @option options [Integer] :timeout (0) The timeout in seconds
+ *     to acquire the lock. See {Groonga::Column#lock}.
+ *   @raise [Groonga::Error] If an update is failed. Updates are
+ *     applied in ID order. Updates for smaller IDs than the failed
+ *     update are already applied.
+ *   @return [Integer] The number of updated records.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_fix_size_column_increment_many (int argc, VALUE *argv, VALUE self)
+{
+    grn_ctx *context = NULL;
+    grn_obj *column;
+    grn_id range_id;
+    grn_bool is_float;
+    VALUE rb_ids, rb_deltas, rb_options;
+    VALUE rb_lock, rb_timeout;
+    VALUE rb_updates_buffer;
+    RbGrnFixSizeColumnUpdate *updates;
+    long i, n_ids, n_updates;
+    grn_bool need_lock = GRN_TRUE;
+    int timeout = 0;
+    grn_obj delta;
+    grn_rc rc = GRN_SUCCESS;
+    uint64_t metrics_start;
+
+    rb_scan_args(argc, argv, "12", &rb_ids, &rb_deltas, &rb_options);
+    if (NIL_P(rb_options) && RB_TYPE_P(rb_deltas, T_HASH)) {
+        rb_options = rb_deltas;
+        rb_deltas = Qnil;
+    }
+    rb_grn_scan_options(rb_options,
+                        "lock", &rb_lock,
+                        "timeout", &rb_timeout,
+                        NULL);
+    if (!NIL_P(rb_lock))
+        need_lock = RVAL2CBOOL(rb_lock);
+    if (!NIL_P(rb_timeout))
+        timeout = NUM2INT(rb_timeout);
+
+    rb_grn_column_deconstruct(SELF(self), &column, &context,
+                              NULL, NULL,
+                              NULL, &range_id, NULL);
+
+    switch (range_id) {
+    case GRN_DB_INT8:
+    case GRN_DB_UINT8:
+    case GRN_DB_INT16:
+    case GRN_DB_UINT16:
+    case GRN_DB_INT32:
+    case GRN_DB_UINT32:
+    case GRN_DB_INT64:
+    case GRN_DB_UINT64:
+        is_float = GRN_FALSE;
+        break;
+    case GRN_DB_FLOAT32:
+    case GRN_DB_FLOAT:
+        is_float = GRN_TRUE;
+        break;
+    default:
+        rb_raise(rb_eArgError,
+                 "increment_many! is available only for numeric column: <%s>",
+                 rb_grn_inspect(self));
+        break;
+    }
+
+    if (RB_TYPE_P(rb_ids, T_STRING)) {
+        if ((RSTRING_LEN(rb_ids) % sizeof(grn_id)) != 0) {
+            rb_raise(rb_eArgError,
+                     "IDs must be packed uint32: <%ld> bytes",
+                     RSTRING_LEN(rb_ids));
+        }
+        n_ids = RSTRING_LEN(rb_ids) / sizeof(grn_id);
+    } else {
+        rb_ids = rb_ary_to_ary(rb_ids);
+        n_ids = RARRAY_LEN(rb_ids);
+    }
+
+    if (RB_TYPE_P(rb_deltas, T_STRING)) {
+        if (RSTRING_LEN(rb_deltas) != (long)(sizeof(int64_t) * n_ids)) {
+            rb_raise(rb_eArgError,
+                     "deltas must be packed %s for <%ld> IDs: <%ld> bytes",
+                     is_float ? "double" : "int64",
+                     n_ids,
+                     RSTRING_LEN(rb_deltas));
+        }
+    } else if (RB_TYPE_P(rb_deltas, T_ARRAY)) {
+        if (RARRAY_LEN(rb_deltas) != n_ids) {
+            rb_raise(rb_eArgError,
+                     "the number of deltas must be the same as "
+                     "the number of IDs: <%ld>: <%ld>",
+                     RARRAY_LEN(rb_deltas), n_ids);
+        }
+    } else if (NIL_P(rb_deltas)) {
+        rb_deltas = INT2NUM(1);
+    }
+
+    rb_updates_buffer = rb_str_new(NULL,
+                                   sizeof(RbGrnFixSizeColumnUpdate) * n_ids);
+    updates = (RbGrnFixSizeColumnUpdate *)RSTRING_PTR(rb_updates_buffer);
+    for (i = 0; i < n_ids; i++) {
+        updates[i].id = rb_grn_fix_size_column_fetch_id(rb_ids, i);
+        if (RB_TYPE_P(rb_deltas, T_STRING)) {
+            memcpy(&(updates[i].delta),
+                   RSTRING_PTR(rb_deltas) + sizeof(int64_t) * i,
+                   sizeof(int64_t));
+        } else {
+            VALUE rb_delta = rb_deltas;
+            if (RB_TYPE_P(rb_deltas, T_ARRAY))
+                rb_delta = RARRAY_AREF(rb_deltas, i);
+            if (is_float) {
+                updates[i].delta.floating_point = NUM2DBL(rb_delta);
+            } else {
+                updates[i].delta.integer = NUM2LL(rb_delta);
+            }
+        }
+    }
+
+    qsort(updates, n_ids, sizeof(RbGrnFixSizeColumnUpdate),
+          rb_grn_fix_size_column_update_compare);
+    n_updates = 0;
+    for (i = 0; i < n_ids; i++) {
+        if (n_updates > 0 && updates[n_updates - 1].id == updates[i].id) {
+            if (is_float) {
+                updates[n_updates - 1].delta.floating_point +=
+                    updates[i].delta.floating_point;
+            } else {
+                updates[n_updates - 1].delta.integer +=
+                    updates[i].delta.integer;
+            }
+        } else {
+            updates[n_updates++] = updates[i];
+        }
+    }
+
+    if (need_lock) {
+        rc = grn_obj_lock(context, column, GRN_ID_NIL, timeout);
+        rb_grn_context_check(context, self);
+        rb_grn_rc_check(rc, self);
+    }
+
+    if (is_float) {
+        GRN_FLOAT_INIT(&delta, 0);
+    } else {
+        GRN_INT64_INIT(&delta, 0);
+    }
+    metrics_start = RB_GRN_METRICS_START();
+    for (i = 0; i < n_updates; i++) {
+        GRN_BULK_REWIND(&delta);
+        if (is_float) {
+            GRN_FLOAT_SET(context, &delta, updates[i].delta.floating_point);
+        } else {
+            GRN_INT64_SET(context, &delta, updates[i].delta.integer);
+        }
+        rc = grn_obj_set_value(context, column, updates[i].id, &delta,
+                               GRN_OBJ_INCR);
+        if (rc != GRN_SUCCESS)
+            break;
+    }
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_WRITE, metrics_start);
+    GRN_OBJ_FIN(context, &delta);
+
+    if (need_lock) {
+        grn_obj_unlock(context, column, GRN_ID_NIL);
+    }
+    if (rb_grn_context_is_recording_changes(context)) {
+        long n_applied_updates = i;
+        for (i = 0; i < n_applied_updates; i++) {
+            rb_grn_context_record_change(context, RB_GRN_CHANGE_INCREMENT,
+                                         column, updates[i].id);
+        }
+    }
+    rb_grn_context_check(context, self);
+    rb_grn_rc_check(rc, self);
+    RB_GC_GUARD(rb_updates_buffer);
+
+    return LONG2NUM(n_updates);
+}
+
 /*
  * Recreates all index columns for the column.
  *
@@ -211,12 +459,15 @@ rb_grn_fix_size_column_reindex (VALUE self)
     grn_rc rc;
     grn_ctx *context;
     grn_obj *column;
+    uint64_t metrics_start;
 
     rb_grn_column_deconstruct(SELF(self), &column, &context,
                               NULL, NULL,
                               NULL, NULL, NULL);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_reindex(context, column);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_REINDEX, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
 
@@ -238,6 +489,8 @@ rb_grn_init_fix_size_column (VALUE mGrn)
                      rb_grn_fix_size_column_increment, -1);
     rb_define_method(rb_cGrnFixSizeColumn, "decrement!",
                      rb_grn_fix_size_column_decrement, -1);
+    rb_define_method(rb_cGrnFixSizeColumn, "increment_many!",
+                     rb_grn_fix_size_column_increment_many, -1);
 
     rb_define_method(rb_cGrnFixSizeColumn, "reindex",
                      rb_grn_fix_size_column_reindex, 0);
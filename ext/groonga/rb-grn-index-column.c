@@ -1393,6 +1393,7 @@ rb_grn_index_column_reindex (VALUE self)
     grn_rc rc;
     grn_ctx *context;
     grn_obj *column;
+    uint64_t metrics_start;
 
     rb_grn_index_column_deconstruct(SELF(self), &column, &context,
                                     NULL, NULL,
@@ -1400,7 +1401,9 @@ rb_grn_index_column_reindex (VALUE self)
                                     NULL, NULL,
                                     NULL, NULL);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_reindex(context, column);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_REINDEX, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
 
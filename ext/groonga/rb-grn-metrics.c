@@ -0,0 +1,382 @@
+/* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License version 2.1 as published by the Free Software Foundation.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "rb-grn.h"
+
+#include <time.h>
+
+/*
+ * Document-module: Groonga::Metrics
+ *
+ * This module provides per operation call counts and latency
+ * histograms of direct API calls such as {Groonga::Table#select}
+ * and {Groonga::Table#sort}. They aren't collected by
+ * {Groonga::QueryLogger} because they aren't executed as commands.
+ *
+ * Metrics are collected only while they are enabled. The cost of
+ * disabled metrics is one flag check per call.
+ *
+ * Metrics are collected for the whole process and for each
+ * {Groonga::Context}. Use {Groonga::Metrics.snapshot} for the
+ * process wide metrics and {Groonga::Context#metrics} for the
+ * context local metrics.
+ *
+ * Latencies are recorded in nanoseconds into log-linear buckets:
+ * each power of two range is split into 8 sub buckets. So the
+ * relative error of a bucket is 12.5% at most.
+ *
+ * @since 12.0.9
+ */
+
+/* Values less than this are recorded into their own bucket. */
+#define N_LINEAR_BUCKETS 16
+#define LINEAR_BUCKETS_BITS 4
+#define SUB_BUCKET_BITS 3
+#define N_SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+/* 2^40ns is about 18 minutes. Larger values are recorded into the
+   last bucket. */
+#define MAX_EXPONENT 40
+#define N_BUCKETS                                                       \
+    (N_LINEAR_BUCKETS +                                                 \
+     (MAX_EXPONENT - LINEAR_BUCKETS_BITS + 1) * N_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t n_calls;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[N_BUCKETS];
+} RbGrnMetricsHistogram;
+
+struct _RbGrnMetrics {
+    RbGrnMetricsHistogram histograms[RB_GRN_METRICS_N_OPERATIONS];
+};
+
+static const char *operation_names[RB_GRN_METRICS_N_OPERATIONS] = {
+    "select",
+    "sort",
+    "group",
+    "column_read",
+    "column_write",
+    "add",
+    "delete",
+    "reindex",
+    "defrag",
+};
+
+static const double percentiles[] = {0.5, 0.9, 0.99, 0.999};
+static const char *percentile_names[] = {"p50", "p90", "p99", "p999"};
+#define N_PERCENTILES (sizeof(percentiles) / sizeof(percentiles[0]))
+
+grn_bool rb_grn_metrics_enabled = GRN_FALSE;
+
+static RbGrnMetrics process_metrics;
+
+uint64_t
+rb_grn_metrics_now (void)
+{
+    struct timespec now;
+
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#else
+    rb_timespec_now(&now);
+#endif
+    return ((uint64_t)now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+static size_t
+rb_grn_metrics_bucket_index (uint64_t value)
+{
+    int exponent;
+    uint64_t sub_bucket;
+
+    if (value < N_LINEAR_BUCKETS)
+        return value;
+
+#ifdef __GNUC__
+    exponent = 63 - __builtin_clzll(value);
+#else
+    exponent = LINEAR_BUCKETS_BITS;
+    while ((value >> (exponent + 1)) > 0) {
+        exponent++;
+    }
+#endif
+    if (exponent > MAX_EXPONENT)
+        return N_BUCKETS - 1;
+
+    sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (N_SUB_BUCKETS - 1);
+    return N_LINEAR_BUCKETS +
+        (exponent - LINEAR_BUCKETS_BITS) * N_SUB_BUCKETS +
+        sub_bucket;
+}
+
+static uint64_t
+rb_grn_metrics_bucket_upper_bound (size_t index)
+{
+    int exponent;
+    uint64_t sub_bucket;
+    uint64_t lower_bound;
+
+    if (index < N_LINEAR_BUCKETS)
+        return index;
+
+    exponent = LINEAR_BUCKETS_BITS + (index - N_LINEAR_BUCKETS) / N_SUB_BUCKETS;
+    sub_bucket = (index - N_LINEAR_BUCKETS) % N_SUB_BUCKETS;
+    lower_bound =
+        (((uint64_t)1) << exponent) +
+        (sub_bucket << (exponent - SUB_BUCKET_BITS));
+    return lower_bound + (((uint64_t)1) << (exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+static void
+rb_grn_metrics_histogram_record (RbGrnMetricsHistogram *histogram,
+                                 uint64_t elapsed)
+{
+    if (histogram->n_calls == 0 || elapsed < histogram->min)
+        histogram->min = elapsed;
+    if (elapsed > histogram->max)
+        histogram->max = elapsed;
+    histogram->n_calls++;
+    histogram->total += elapsed;
+    histogram->buckets[rb_grn_metrics_bucket_index(elapsed)]++;
+}
+
+void
+rb_grn_metrics_record (grn_ctx *context,
+                       RbGrnMetricsOperation operation,
+                       uint64_t start)
+{
+    uint64_t elapsed;
+    RbGrnContext *rb_grn_context;
+
+    elapsed = rb_grn_metrics_now() - start;
+
+    rb_grn_metrics_histogram_record(&(process_metrics.histograms[operation]),
+                                    elapsed);
+
+    if (!context)
+        return;
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    if (!rb_grn_context)
+        return;
+    if (!rb_grn_context->metrics)
+        rb_grn_context->metrics = ZALLOC(RbGrnMetrics);
+    rb_grn_metrics_histogram_record(&(rb_grn_context->metrics->histograms[operation]),
+                                    elapsed);
+}
+
+void
+rb_grn_metrics_free (RbGrnMetrics *metrics)
+{
+    if (metrics)
+        xfree(metrics);
+}
+
+void
+rb_grn_metrics_reset (RbGrnMetrics *metrics)
+{
+    if (metrics)
+        memset(metrics, 0, sizeof(RbGrnMetrics));
+}
+
+static VALUE
+rb_grn_metrics_nanoseconds_to_ruby_object (uint64_t nanoseconds)
+{
+    return rb_float_new(nanoseconds / 1000000000.0);
+}
+
+static VALUE
+rb_grn_metrics_histogram_to_ruby_object (RbGrnMetricsHistogram *histogram)
+{
+    VALUE rb_histogram;
+    VALUE rb_buckets;
+    size_t i, j;
+    uint64_t n_accumulated_calls = 0;
+    uint64_t percentile_values[N_PERCENTILES];
+
+    rb_histogram = rb_hash_new();
+    rb_hash_aset(rb_histogram,
+                 RB_GRN_INTERN("n_calls"),
+                 ULL2NUM(histogram->n_calls));
+    rb_hash_aset(rb_histogram,
+                 RB_GRN_INTERN("total_time"),
+                 rb_grn_metrics_nanoseconds_to_ruby_object(histogram->total));
+    rb_hash_aset(rb_histogram,
+                 RB_GRN_INTERN("min_time"),
+                 rb_grn_metrics_nanoseconds_to_ruby_object(histogram->min));
+    rb_hash_aset(rb_histogram,
+                 RB_GRN_INTERN("max_time"),
+                 rb_grn_metrics_nanoseconds_to_ruby_object(histogram->max));
+
+    memset(percentile_values, 0, sizeof(percentile_values));
+    rb_buckets = rb_ary_new();
+    j = 0;
+    for (i = 0; i < N_BUCKETS; i++) {
+        uint64_t n_calls = histogram->buckets[i];
+        uint64_t upper_bound;
+
+        if (n_calls == 0)
+            continue;
+
+        upper_bound = rb_grn_metrics_bucket_upper_bound(i);
+        if (upper_bound > histogram->max)
+            upper_bound = histogram->max;
+        n_accumulated_calls += n_calls;
+        for (; j < N_PERCENTILES; j++) {
+            if (n_accumulated_calls < histogram->n_calls * percentiles[j])
+                break;
+            percentile_values[j] = upper_bound;
+        }
+        rb_ary_push(rb_buckets,
+                    rb_ary_new_from_args(2,
+                                         rb_grn_metrics_nanoseconds_to_ruby_object(upper_bound),
+                                         ULL2NUM(n_calls)));
+    }
+    for (j = 0; j < N_PERCENTILES; j++) {
+        rb_hash_aset(rb_histogram,
+                     RB_GRN_INTERN(percentile_names[j]),
+                     rb_grn_metrics_nanoseconds_to_ruby_object(percentile_values[j]));
+    }
+    rb_hash_aset(rb_histogram, RB_GRN_INTERN("buckets"), rb_buckets);
+
+    return rb_histogram;
+}
+
+VALUE
+rb_grn_metrics_to_ruby_object (RbGrnMetrics *metrics)
+{
+    static RbGrnMetrics empty_metrics;
+    VALUE rb_metrics;
+    int i;
+
+    if (!metrics)
+        metrics = &empty_metrics;
+
+    rb_metrics = rb_hash_new();
+    for (i = 0; i < RB_GRN_METRICS_N_OPERATIONS; i++) {
+        rb_hash_aset(rb_metrics,
+                     RB_GRN_INTERN(operation_names[i]),
+                     rb_grn_metrics_histogram_to_ruby_object(&(metrics->histograms[i])));
+    }
+
+    return rb_metrics;
+}
+
+/*
+ * Enables metrics collection.
+ *
+ * @overload enable
+ *   @return [void]
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_metrics_s_enable (VALUE klass)
+{
+    rb_grn_metrics_enabled = GRN_TRUE;
+    return Qnil;
+}
+
+/*
+ * Disables metrics collection. Collected metrics are kept.
+ *
+ * @overload disable
+ *   @return [void]
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_metrics_s_disable (VALUE klass)
+{
+    rb_grn_metrics_enabled = GRN_FALSE;
+    return Qnil;
+}
+
+/*
+ * @overload enabled?
+ *   @return [Boolean] `true` if metrics are collected, `false` otherwise.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_metrics_s_enabled_p (VALUE klass)
+{
+    return CBOOL2RVAL(rb_grn_metrics_enabled);
+}
+
+/*
+ * Returns the process wide metrics. Keys are operation names:
+ * `:select`, `:sort`, `:group`, `:column_read`, `:column_write`,
+ * `:add`, `:delete`, `:reindex` and `:defrag`. Each value has the
+ * following keys:
+ *
+ *   * `:n_calls`: The number of calls.
+ *   * `:total_time`, `:min_time`, `:max_time`: In seconds.
+ *   * `:p50`, `:p90`, `:p99`, `:p999`: Percentiles in seconds.
+ *   * `:buckets`: `[[upper_bound_in_seconds, n_calls], ...]` of
+ *     non empty buckets in ascending order.
+ *
+ * @example Dump select latency
+ *   Groonga::Metrics.enable
+ *   users.select {|record| record.age > 20}
+ *   p Groonga::Metrics.snapshot[:select][:p99]
+ *
+ * @overload snapshot
+ *   @return [::Hash{Symbol => ::Hash}] The collected metrics.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_metrics_s_snapshot (VALUE klass)
+{
+    return rb_grn_metrics_to_ruby_object(&process_metrics);
+}
+
+/*
+ * Clears the process wide metrics. Context local metrics aren't
+ * cleared. Use {Groonga::Context#reset_metrics} for them.
+ *
+ * @overload reset
+ *   @return [void]
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_metrics_s_reset (VALUE klass)
+{
+    rb_grn_metrics_reset(&process_metrics);
+    return Qnil;
+}
+
+void
+rb_grn_init_metrics (VALUE mGrn)
+{
+    VALUE mGrnMetrics;
+
+    mGrnMetrics = rb_define_module_under(mGrn, "Metrics");
+
+    rb_define_singleton_method(mGrnMetrics, "enable",
+                               rb_grn_metrics_s_enable, 0);
+    rb_define_singleton_method(mGrnMetrics, "disable",
+                               rb_grn_metrics_s_disable, 0);
+    rb_define_singleton_method(mGrnMetrics, "enabled?",
+                               rb_grn_metrics_s_enabled_p, 0);
+    rb_define_singleton_method(mGrnMetrics, "snapshot",
+                               rb_grn_metrics_s_snapshot, 0);
+    rb_define_singleton_method(mGrnMetrics, "reset",
+                               rb_grn_metrics_s_reset, 0);
+}
@@ -223,6 +223,15 @@ rb_grn_object_finalizer (grn_ctx *context, int n_args, grn_obj **grn_objects,
 
 void
 rb_grn_object_free (RbGrnObject *rb_grn_object)
+{
+    if (!rb_grn_exited && rb_grn_context_defer_object_release(rb_grn_object))
+        return;
+
+    rb_grn_object_release(rb_grn_object);
+}
+
+void
+rb_grn_object_release (RbGrnObject *rb_grn_object)
 {
     grn_ctx *context;
     grn_obj *grn_object;
@@ -260,6 +269,37 @@ rb_grn_object_free (RbGrnObject *rb_grn_object)
     xfree(rb_grn_object);
 }
 
+/*
+ * It releases a Ruby object queued by
+ * rb_grn_context_defer_object_release(). The Groonga finalizer and
+ * user data of the Groonga object are already detached from it. So
+ * it's released through its own struct. If _owner_ is false, the
+ * Groonga object is owned by another Ruby object and isn't closed.
+ */
+void
+rb_grn_object_release_deferred (RbGrnObject *rb_grn_object, grn_bool owner)
+{
+    grn_ctx *context;
+    grn_obj *grn_object;
+
+    context = rb_grn_object->context;
+    grn_object = rb_grn_object->object;
+    debug("rb-free(deferred): %p:%p:%p; %d:%d:%d\n",
+          context, grn_object, rb_grn_object,
+          rb_grn_object->have_finalizer, rb_grn_object->need_close, owner);
+    if (!rb_grn_exited && context && grn_object) {
+        if (rb_grn_object->have_finalizer) {
+            rb_grn_object_run_finalizer(context, grn_object, rb_grn_object);
+        } else {
+            rb_grn_object_unbind(rb_grn_object);
+        }
+        if (owner && rb_grn_object->need_close) {
+            grn_obj_unlink(context, grn_object);
+        }
+    }
+    xfree(rb_grn_object);
+}
+
 VALUE
 rb_grn_object_to_ruby_class (grn_obj *object)
 {
@@ -342,6 +382,9 @@ rb_grn_object_to_ruby_object (VALUE klass, grn_ctx *context, grn_obj *object,
     if (user_data && user_data->ptr) {
         return RB_GRN_OBJECT(user_data->ptr)->self;
     }
+    if (user_data) {
+        rb_grn_context_release_deferred_object(context, object);
+    }
 
     if (NIL_P(klass))
         klass = GRNOBJECT2RCLASS(object);
@@ -395,6 +438,7 @@ rb_grn_object_bind_common (VALUE klass, VALUE self, VALUE rb_context,
     rb_grn_object->need_close = GRN_TRUE;
     rb_grn_object->have_finalizer = GRN_FALSE;
     rb_grn_object->floating = GRN_FALSE;
+    rb_grn_object->next_deferred = NULL;
 
     user_data = grn_obj_user_data(context, object);
     if (user_data) {
@@ -1342,6 +1386,7 @@ rb_grn_object_array_reference (VALUE self, VALUE rb_id)
     unsigned char range_type;
     grn_obj value;
     VALUE rb_value = Qnil;
+    uint64_t metrics_start;
 
     rb_grn_object = SELF(self);
     context = rb_grn_object->context;
@@ -1392,7 +1437,9 @@ rb_grn_object_array_reference (VALUE self, VALUE rb_id)
         break;
     }
 
+    metrics_start = RB_GRN_METRICS_START();
     grn_obj_get_value(context, object, id, &value);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_READ, metrics_start);
     exception = rb_grn_context_to_exception(context, self);
     if (NIL_P(exception))
         rb_value = GRNVALUE2RVAL(context, &value, range, self);
@@ -1449,6 +1496,7 @@ rb_grn_object_set_raw_body (VALUE user_data)
     grn_rc rc;
     VALUE rb_value, rb_values;
     VALUE related_object;
+    uint64_t metrics_start;
 
     rb_grn_object = data->rb_grn_object;
     context = rb_grn_object->context;
@@ -1472,10 +1520,14 @@ rb_grn_object_set_raw_body (VALUE user_data)
             RVAL2GRNVECTOR(rb_values, context, value);
         }
     }
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_set_value(context, rb_grn_object->object, data->id,
                            value, data->flags);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_WRITE, metrics_start);
     rb_grn_context_check(context, related_object);
     rb_grn_rc_check(rc, related_object);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_SET,
+                                 rb_grn_object->object, data->id);
 
     return Qnil;
 }
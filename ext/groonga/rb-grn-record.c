@@ -23,7 +23,37 @@ VALUE rb_cGrnRecord;
 VALUE
 rb_grn_record_new (VALUE table, grn_id id, VALUE values)
 {
-    return rb_grn_record_new_raw(table, UINT2NUM(id), values);
+    RbGrnObject *rb_grn_table;
+    VALUE rb_identity_map;
+    VALUE rb_records;
+    VALUE rb_id;
+    VALUE rb_record;
+
+    rb_id = UINT2NUM(id);
+    if (!NIL_P(values))
+        return rb_grn_record_new_raw(table, rb_id, values);
+
+    rb_grn_table = RB_GRN_OBJECT(RTYPEDDATA_DATA(table));
+    if (!rb_grn_table || !rb_grn_table->context)
+        return rb_grn_record_new_raw(table, rb_id, values);
+
+    rb_identity_map =
+        rb_grn_context_get_record_identity_map(rb_grn_table->context);
+    if (NIL_P(rb_identity_map))
+        return rb_grn_record_new_raw(table, rb_id, values);
+
+    rb_records = rb_hash_lookup(rb_identity_map, table);
+    if (NIL_P(rb_records)) {
+        rb_records = rb_hash_new();
+        rb_hash_aset(rb_identity_map, table, rb_records);
+    }
+    rb_record = rb_hash_lookup(rb_records, rb_id);
+    if (NIL_P(rb_record)) {
+        rb_record = rb_grn_record_new_raw(table, rb_id, values);
+        rb_hash_aset(rb_records, rb_id, rb_record);
+    }
+
+    return rb_record;
 }
 
 VALUE
@@ -31,11 +61,22 @@ rb_grn_record_new_added (VALUE table, grn_id id, VALUE values)
 {
     VALUE record;
 
-    record = rb_grn_record_new(table, id, values);
+    /* Don't share the record by the identity map because it's
+     * marked as added. */
+    record = rb_grn_record_new_raw(table, UINT2NUM(id), values);
     rb_funcall(record, rb_intern("added="), 1, Qtrue);
     return record;
 }
 
+void
+rb_grn_record_reset_id (VALUE record, grn_id id)
+{
+    ID id_reset_id;
+
+    CONST_ID(id_reset_id, "reset_id");
+    rb_funcall(record, id_reset_id, 1, UINT2NUM(id));
+}
+
 VALUE
 rb_grn_record_new_raw (VALUE table, VALUE rb_id, VALUE values)
 {
@@ -235,25 +235,52 @@ rb_grn_table_cursor_next (VALUE self)
 /*
  * カーソルの範囲内にあるレコードを順番にブロックに渡す。
  *
- * @overload each
+ * @overload each(options={})
+ *   @param options [::Hash] The name and value
+ *     pairs. Omitted names are initialized as the default value.
+ *   @option options [Boolean] :flyweight (false)
+ *     If it's `true`, one {Groonga::Record} is yielded for all
+ *     records. See {Groonga::Table#each}.
+ *
+ *     @since 12.0.9
  *   @yield [record]
  */
 static VALUE
-rb_grn_table_cursor_each (VALUE self)
+rb_grn_table_cursor_each (int argc, VALUE *argv, VALUE self)
 {
     grn_id record_id;
     grn_ctx *context;
     grn_table_cursor *cursor;
+    VALUE rb_options, rb_flyweight;
+    VALUE rb_table;
+    VALUE rb_record = Qnil;
+    grn_bool flyweight;
+
+    RETURN_ENUMERATOR(self, argc, argv);
 
-    RETURN_ENUMERATOR(self, 0, NULL);
+    rb_scan_args(argc, argv, "01", &rb_options);
+    rb_grn_scan_options(rb_options,
+                        "flyweight", &rb_flyweight,
+                        NULL);
+    flyweight = RVAL2CBOOL(rb_flyweight);
 
     rb_grn_table_cursor_deconstruct(SELF(self), &cursor, &context,
                                     NULL, NULL, NULL, NULL);
 
     if (context && cursor) {
+        rb_table = rb_iv_get(self, "@table");
         while ((record_id = grn_table_cursor_next(context, cursor))) {
-            rb_yield(rb_grn_record_new(rb_iv_get(self, "@table"),
-                                       record_id, Qnil));
+            if (!flyweight) {
+                rb_yield(rb_grn_record_new(rb_table, record_id, Qnil));
+            } else if (NIL_P(rb_record)) {
+                rb_record = rb_grn_record_new_raw(rb_table,
+                                                  UINT2NUM(record_id),
+                                                  Qnil);
+                rb_yield(rb_record);
+            } else {
+                rb_grn_record_reset_id(rb_record, record_id);
+                rb_yield(rb_record);
+            }
         }
     }
 
@@ -297,7 +324,7 @@ rb_grn_init_table_cursor (VALUE mGrn)
                      rb_grn_table_cursor_next, 0);
 
     rb_define_method(rb_cGrnTableCursor, "each",
-                     rb_grn_table_cursor_each, 0);
+                     rb_grn_table_cursor_each, -1);
 
     rb_grn_init_table_cursor_key_support(mGrn);
     rb_grn_init_array_cursor(mGrn);
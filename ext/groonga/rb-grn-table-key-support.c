@@ -213,18 +213,27 @@ rb_grn_table_key_support_add_raw (VALUE self, VALUE rb_key, int *added)
     grn_obj *table;
     grn_id id, domain_id;
     grn_obj *key, *domain;
+    int local_added = GRN_FALSE;
+    uint64_t metrics_start;
 
     rb_grn_table_key_support_deconstruct(SELF(self), &table, &context,
                                          &key, &domain_id, &domain,
                                          NULL, NULL, NULL,
                                          NULL);
 
+    if (!added)
+        added = &local_added;
     GRN_BULK_REWIND(key);
     RVAL2GRNKEY(rb_key, context, key, domain_id, domain, self);
+    metrics_start = RB_GRN_METRICS_START();
     id = grn_table_add(context, table,
                        GRN_BULK_HEAD(key), GRN_BULK_VSIZE(key), added);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_ADD, metrics_start);
     rb_grn_context_check(context, self);
 
+    if (id != GRN_ID_NIL && *added)
+        rb_grn_context_record_change(context, RB_GRN_CHANGE_ADD, table, id);
+
     return id;
 }
 
@@ -265,6 +274,92 @@ rb_grn_table_key_support_add (int argc, VALUE *argv, VALUE self)
     }
 }
 
+/*
+ * Adds records for _keys_ in one call. Values of the records
+ * aren't set. Existing keys are ignored.
+ *
+ * It's faster than calling {#add} for each key because no
+ * {Groonga::Record} is created. Adding keys in sorted order is
+ * faster for {Groonga::PatriciaTrie} and
+ * {Groonga::DoubleArrayTrie}. See also {Groonga::LexiconBuilder}.
+ *
+ * @example Add sorted words
+ *   words.add_keys(["apple", "banana", "cherry"]) # => 3
+ *
+ * @overload add_keys(keys)
+ *   @param keys [::Array] The keys to be added.
+ *   @raise [Groonga::Error] If a key can't be added. Keys before
+ *     the key are added.
+ *   @return [Integer] The number of newly added records.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_table_key_support_add_keys (VALUE self, VALUE rb_keys)
+{
+    grn_ctx *context;
+    grn_obj *table;
+    grn_id domain_id;
+    grn_obj *key, *domain;
+    long i, n_keys;
+    long n_added = 0;
+    long failed_index = -1;
+    VALUE rb_added_ids = Qnil;
+    uint64_t metrics_start;
+
+    rb_grn_table_key_support_deconstruct(SELF(self), &table, &context,
+                                         &key, &domain_id, &domain,
+                                         NULL, NULL, NULL,
+                                         NULL);
+
+    rb_keys = rb_ary_to_ary(rb_keys);
+    n_keys = RARRAY_LEN(rb_keys);
+    if (rb_grn_context_is_recording_changes(context))
+        rb_added_ids = rb_ary_new();
+    metrics_start = RB_GRN_METRICS_START();
+    for (i = 0; i < n_keys; i++) {
+        grn_id id;
+        int added = GRN_FALSE;
+
+        GRN_BULK_REWIND(key);
+        RVAL2GRNKEY(RARRAY_AREF(rb_keys, i), context, key,
+                    domain_id, domain, self);
+        id = grn_table_add(context, table,
+                           GRN_BULK_HEAD(key), GRN_BULK_VSIZE(key), &added);
+        if (id == GRN_ID_NIL) {
+            failed_index = i;
+            break;
+        }
+        if (added) {
+            n_added++;
+            if (!NIL_P(rb_added_ids))
+                rb_ary_push(rb_added_ids, UINT2NUM(id));
+        }
+    }
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_ADD, metrics_start);
+
+    /* Keys added before the failed key are recorded. */
+    if (!NIL_P(rb_added_ids)) {
+        for (i = 0; i < RARRAY_LEN(rb_added_ids); i++) {
+            rb_grn_context_record_change(context, RB_GRN_CHANGE_ADD, table,
+                                         NUM2UINT(RARRAY_AREF(rb_added_ids,
+                                                              i)));
+        }
+    }
+
+    rb_grn_context_check(context, self);
+    if (failed_index >= 0) {
+        rb_raise(rb_eGrnError,
+                 "failed to add a key: <%" PRIsVALUE ">: "
+                 "%ld key(s) were added: %" PRIsVALUE,
+                 rb_inspect(RARRAY_AREF(rb_keys, failed_index)),
+                 n_added,
+                 self);
+    }
+
+    return LONG2NUM(n_added);
+}
+
 grn_id
 rb_grn_table_key_support_get (VALUE self, VALUE rb_key)
 {
@@ -386,9 +481,11 @@ rb_grn_table_key_support_delete_by_key (VALUE self, VALUE rb_key)
 {
     grn_ctx *context;
     grn_obj *table;
+    grn_id id = GRN_ID_NIL;
     grn_id domain_id;
     grn_obj *key, *domain;
     grn_rc rc;
+    uint64_t metrics_start;
 
     rb_grn_table_key_support_deconstruct(SELF(self), &table, &context,
                                          &key, &domain_id, &domain,
@@ -397,10 +494,18 @@ rb_grn_table_key_support_delete_by_key (VALUE self, VALUE rb_key)
 
     GRN_BULK_REWIND(key);
     RVAL2GRNKEY(rb_key, context, key, domain_id, domain, self);
+    if (rb_grn_context_is_recording_changes(context)) {
+        id = grn_table_get(context, table,
+                           GRN_BULK_HEAD(key), GRN_BULK_VSIZE(key));
+    }
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_table_delete(context, table,
                           GRN_BULK_HEAD(key), GRN_BULK_VSIZE(key));
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_DELETE, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    if (id != GRN_ID_NIL)
+        rb_grn_context_record_change(context, RB_GRN_CHANGE_DELETE, table, id);
 
     return Qnil;
 }
@@ -714,6 +819,7 @@ rb_grn_table_key_support_set_value_by_key (VALUE self,
     rc = grn_obj_set_value(context, table, id, value, GRN_OBJ_SET);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_SET, table, id);
 
     return rb_value;
 }
@@ -1122,13 +1228,16 @@ rb_grn_table_key_support_reindex (VALUE self)
     grn_rc rc;
     grn_ctx *context;
     grn_obj *table;
+    uint64_t metrics_start;
 
     rb_grn_table_key_support_deconstruct(SELF(self), &table, &context,
                                          NULL, NULL, NULL,
                                          NULL, NULL, NULL,
                                          NULL);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_reindex(context, table);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_REINDEX, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
 
@@ -1146,6 +1255,8 @@ rb_grn_init_table_key_support (VALUE mGrn)
 
     rb_define_method(rb_mGrnTableKeySupport, "add",
                      rb_grn_table_key_support_add, -1);
+    rb_define_method(rb_mGrnTableKeySupport, "add_keys",
+                     rb_grn_table_key_support_add_keys, 1);
     rb_define_method(rb_mGrnTableKeySupport, "id",
                      rb_grn_table_key_support_get_id, -1);
     rb_define_method(rb_mGrnTableKeySupport, "key",
@@ -20,6 +20,8 @@
 
 #include "rb-grn.h"
 
+#include <ruby/thread.h>
+
 /*
  * Document-class: Groonga::Table < Groonga::Object
  *
@@ -1070,6 +1072,7 @@ typedef struct {
     grn_ctx *context;
     grn_table_cursor *cursor;
     VALUE self;
+    grn_bool flyweight;
 } EachData;
 
 static VALUE
@@ -1080,6 +1083,7 @@ rb_grn_table_each_body (VALUE user_data)
     grn_table_cursor *cursor = data->cursor;
     VALUE self = data->self;
     RbGrnObject *rb_grn_object;
+    VALUE rb_record = Qnil;
 
     rb_grn_object = RB_GRN_OBJECT(SELF(self));
     while (GRN_TRUE) {
@@ -1094,7 +1098,15 @@ rb_grn_table_each_body (VALUE user_data)
             break;
         }
 
-        rb_yield(rb_grn_record_new(self, id, Qnil));
+        if (!data->flyweight) {
+            rb_yield(rb_grn_record_new(self, id, Qnil));
+        } else if (NIL_P(rb_record)) {
+            rb_record = rb_grn_record_new_raw(self, UINT2NUM(id), Qnil);
+            rb_yield(rb_record);
+        } else {
+            rb_grn_record_reset_id(rb_record, id);
+            rb_yield(rb_record);
+        }
     }
 
     return Qnil;
@@ -1113,7 +1125,13 @@ rb_grn_table_each_ensure (VALUE user_data)
 /*
  * テーブルに登録されているレコードを順番にブロックに渡す。
  *
- * _options_ is the same as {#open_cursor} 's one.
+ * _options_ is the same as {#open_cursor} 's one except
+ * `:flyweight`.
+ *
+ * @example Iterate records without creating a record for each one
+ *   users.each(:flyweight => true) do |user|
+ *     puts(user.name)
+ *   end
  *
  * @overload each
  *   @!macro [new] table.each.metadata
@@ -1122,15 +1140,35 @@ rb_grn_table_each_ensure (VALUE user_data)
  *   @!macro table.each.metadata
  * @overload each(options={})
  *   @!macro table.each.metadata
+ *   @option options [Boolean] :flyweight (false)
+ *     If it's `true`, one {Groonga::Record} is yielded for all
+ *     records. It points to the current record. It reduces
+ *     allocations. Don't keep the yielded record after the block.
+ *     Use {Groonga::Record#id} to keep it.
+ *
+ *     @since 12.0.9
  */
 static VALUE
 rb_grn_table_each (int argc, VALUE *argv, VALUE self)
 {
     EachData data;
+    VALUE rb_options = Qnil;
 
     RETURN_ENUMERATOR(self, argc, argv);
 
-    data.cursor = rb_grn_table_open_grn_cursor(argc, argv, self,
+    rb_scan_args(argc, argv, "01", &rb_options);
+    data.flyweight = GRN_FALSE;
+    if (RB_TYPE_P(rb_options, T_HASH)) {
+        /* :flyweight isn't a cursor option. */
+        rb_options = rb_hash_dup(rb_options);
+        data.flyweight =
+            RVAL2CBOOL(rb_hash_delete(rb_options,
+                                      ID2SYM(rb_intern("flyweight"))));
+    }
+
+    data.cursor = rb_grn_table_open_grn_cursor(NIL_P(rb_options) ? 0 : 1,
+                                               &rb_options,
+                                               self,
                                                &(data.context));
     if (!data.cursor) {
         return Qnil;
@@ -1150,6 +1188,7 @@ rb_grn_table_delete_by_id (VALUE self, VALUE rb_id)
     grn_obj *table;
     grn_id id;
     grn_rc rc;
+    uint64_t metrics_start;
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
                              NULL, NULL,
@@ -1157,8 +1196,11 @@ rb_grn_table_delete_by_id (VALUE self, VALUE rb_id)
                              NULL);
 
     id = NUM2UINT(rb_id);
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_table_delete_by_id(context, table, id);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_DELETE, metrics_start);
     rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_DELETE, table, id);
 
     return Qnil;
 }
@@ -1172,6 +1214,8 @@ rb_grn_table_delete_by_expression (VALUE self)
     grn_obj *needless_records, *expression;
     grn_operator operator = GRN_OP_OR;
     grn_table_cursor *cursor;
+    VALUE rb_deleted_ids = Qnil;
+    uint64_t metrics_start;
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
                              NULL, NULL,
@@ -1194,6 +1238,9 @@ rb_grn_table_delete_by_expression (VALUE self)
         rb_grn_rc_check(GRN_NO_MEMORY_AVAILABLE, self);
     }
 
+    if (rb_grn_context_is_recording_changes(context))
+        rb_deleted_ids = rb_ary_new();
+    metrics_start = RB_GRN_METRICS_START();
     grn_table_select(context, table, expression, needless_records, operator);
     cursor = grn_table_cursor_open(context, needless_records,
                                    NULL, 0,
@@ -1203,12 +1250,25 @@ rb_grn_table_delete_by_expression (VALUE self)
         while (grn_table_cursor_next(context, cursor)) {
             grn_id *id;
             grn_table_cursor_get_key(context, cursor, (void **)&id);
-            grn_table_delete_by_id(context, table, *id);
+            if (grn_table_delete_by_id(context, table, *id) == GRN_SUCCESS &&
+                !NIL_P(rb_deleted_ids)) {
+                rb_ary_push(rb_deleted_ids, UINT2NUM(*id));
+            }
         }
         grn_table_cursor_close(context, cursor);
     }
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_DELETE, metrics_start);
     grn_obj_unlink(context, needless_records);
 
+    if (!NIL_P(rb_deleted_ids)) {
+        long i;
+        for (i = 0; i < RARRAY_LEN(rb_deleted_ids); i++) {
+            rb_grn_context_record_change(context, RB_GRN_CHANGE_DELETE, table,
+                                         NUM2UINT(RARRAY_AREF(rb_deleted_ids,
+                                                              i)));
+        }
+    }
+
     return Qnil;
 }
 
@@ -1349,6 +1409,7 @@ rb_grn_table_sort (int argc, VALUE *argv, VALUE self)
     VALUE rb_keys, options;
     VALUE rb_offset, rb_limit;
     VALUE exception;
+    uint64_t metrics_start;
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
                              NULL, NULL,
@@ -1380,7 +1441,9 @@ rb_grn_table_sort (int argc, VALUE *argv, VALUE self)
     /* use n_records that is return value from
        grn_table_sort() when Rroonga user become specifying
        output table. */
+    metrics_start = RB_GRN_METRICS_START();
     grn_table_sort(context, table, offset, limit, result, keys, n_keys);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_SORT, metrics_start);
     exception = rb_grn_context_to_exception(context, self);
     if (!NIL_P(exception)) {
         grn_obj_unlink(context, result);
@@ -1445,6 +1508,7 @@ rb_grn_table_geo_sort (int argc, VALUE *argv, VALUE self)
     int limit = -1;
     grn_obj *result;
     VALUE exception;
+    uint64_t metrics_start;
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
                              NULL, NULL,
@@ -1486,8 +1550,10 @@ rb_grn_table_geo_sort (int argc, VALUE *argv, VALUE self)
 
     result = grn_table_create(context, NULL, 0, NULL, GRN_TABLE_NO_KEY,
                               NULL, table);
+    metrics_start = RB_GRN_METRICS_START();
     grn_geo_table_sort(context, table, offset, limit,
                        result, column, &base_geo_point);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_SORT, metrics_start);
     exception = rb_grn_context_to_exception(context, self);
     if (!NIL_P(exception)) {
         grn_obj_unlink(context, &base_geo_point);
@@ -1567,6 +1633,7 @@ rb_grn_table_group (int argc, VALUE *argv, VALUE self)
     VALUE rb_keys, rb_options, rb_max_n_sub_records;
     VALUE rb_calc_target, rb_calc_types;
     VALUE *rb_group_keys;
+    uint64_t metrics_start;
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
                              NULL, NULL,
@@ -1669,7 +1736,9 @@ rb_grn_table_group (int argc, VALUE *argv, VALUE self)
         }
     }
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_table_group(context, table, keys, n_keys, &result, 1);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_GROUP, metrics_start);
     if (result.calc_target) {
         grn_obj_unlink(context, result.calc_target);
     }
@@ -1679,6 +1748,283 @@ rb_grn_table_group (int argc, VALUE *argv, VALUE self)
     return GRNOBJECT2RVAL(Qnil, context, result.table, GRN_TRUE);
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *buckets;
+    int limit;
+    VALUE related_object;
+    grn_table_sort_key sort_keys[2];
+    grn_obj *sorted;
+    grn_table_cursor *cursor;
+    grn_obj n_sub_records;
+} DrilldownPackData;
+
+static VALUE
+rb_grn_table_drilldown_pack_body (VALUE user_data)
+{
+    DrilldownPackData *data = (DrilldownPackData *)user_data;
+    grn_ctx *context = data->context;
+    grn_obj *buckets = data->buckets;
+    grn_id sorted_id;
+    char key[GRN_TABLE_MAX_KEY_SIZE];
+    VALUE rb_keys, rb_counts;
+    uint64_t metrics_start;
+
+    data->sort_keys[0].key = grn_obj_column(context, buckets,
+                                            "_nsubrecs", strlen("_nsubrecs"));
+    data->sort_keys[0].flags = GRN_TABLE_SORT_DESC;
+    data->sort_keys[1].key = grn_obj_column(context, buckets,
+                                            "_key", strlen("_key"));
+    data->sort_keys[1].flags = GRN_TABLE_SORT_ASC;
+    data->sorted = grn_table_create(context, NULL, 0, NULL, GRN_TABLE_NO_KEY,
+                                    NULL, buckets);
+    rb_grn_context_check(context, data->related_object);
+    metrics_start = RB_GRN_METRICS_START();
+    grn_table_sort(context, buckets, 0, data->limit, data->sorted,
+                   data->sort_keys, 2);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_SORT, metrics_start);
+    rb_grn_context_check(context, data->related_object);
+
+    rb_keys = rb_ary_new();
+    rb_counts = rb_ary_new();
+    data->cursor = grn_table_cursor_open(context, data->sorted,
+                                         NULL, 0, NULL, 0,
+                                         0, -1, GRN_CURSOR_ASCENDING);
+    rb_grn_context_check(context, data->related_object);
+    while ((sorted_id = grn_table_cursor_next(context, data->cursor)) !=
+           GRN_ID_NIL) {
+        void *value;
+        grn_id bucket_id;
+        int key_size;
+
+        grn_table_cursor_get_value(context, data->cursor, &value);
+        bucket_id = *((grn_id *)value);
+        key_size = grn_table_get_key(context, buckets, bucket_id,
+                                     key, GRN_TABLE_MAX_KEY_SIZE);
+        rb_ary_push(rb_keys,
+                    GRNKEY2RVAL(context, key, key_size, buckets,
+                                data->related_object));
+        GRN_BULK_REWIND(&(data->n_sub_records));
+        grn_obj_get_value(context, data->sort_keys[0].key, bucket_id,
+                          &(data->n_sub_records));
+        rb_ary_push(rb_counts,
+                    INT2NUM(GRN_INT32_VALUE(&(data->n_sub_records))));
+    }
+    rb_grn_context_check(context, data->related_object);
+
+    return rb_ary_new_from_args(2, rb_keys, rb_counts);
+}
+
+static VALUE
+rb_grn_table_drilldown_pack_ensure (VALUE user_data)
+{
+    DrilldownPackData *data = (DrilldownPackData *)user_data;
+    grn_ctx *context = data->context;
+
+    if (data->cursor)
+        grn_table_cursor_close(context, data->cursor);
+    GRN_OBJ_FIN(context, &(data->n_sub_records));
+    if (data->sorted)
+        grn_obj_unlink(context, data->sorted);
+    if (data->sort_keys[0].key)
+        grn_obj_unlink(context, data->sort_keys[0].key);
+    if (data->sort_keys[1].key)
+        grn_obj_unlink(context, data->sort_keys[1].key);
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_drilldown_pack (grn_ctx *context, grn_obj *buckets, int limit,
+                             VALUE related_object)
+{
+    DrilldownPackData data;
+
+    data.context = context;
+    data.buckets = buckets;
+    data.limit = limit;
+    data.related_object = related_object;
+    data.sort_keys[0].key = NULL;
+    data.sort_keys[1].key = NULL;
+    data.sorted = NULL;
+    data.cursor = NULL;
+    GRN_INT32_INIT(&(data.n_sub_records), 0);
+
+    return rb_ensure(rb_grn_table_drilldown_pack_body, (VALUE)&data,
+                     rb_grn_table_drilldown_pack_ensure, (VALUE)&data);
+}
+
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    grn_table_sort_key *keys;
+    int n_keys;
+    grn_table_group_result *results;
+    grn_rc rc;
+} DrilldownGroupData;
+
+static void *
+rb_grn_table_drilldown_group_without_gvl (void *user_data)
+{
+    DrilldownGroupData *data = user_data;
+
+    data->rc = grn_table_group(data->context, data->table,
+                               data->keys, data->n_keys,
+                               data->results, data->n_keys);
+    return NULL;
+}
+
+/*
+ * Groups the table by each key in _keys_. It's for faceted search
+ * that computes many facets against the same result set.
+ *
+ * All facets are computed by one scan of the table. Each key has
+ * its own grouped table. The GVL is released while the table is
+ * scanned. So other Ruby threads can run but they must not use the
+ * same context during the scan.
+ *
+ * `:packed => true` avoids creating {Groonga::Record} objects for
+ * buckets.
+ *
+ * @example Compute facets as grouped tables
+ *   facets = entries.drilldown(["category", "tags"])
+ *   facets["category"].each do |category|
+ *     p [category.key, category.n_sub_records]
+ *   end
+ *
+ * @example Compute top 10 buckets of each facet as packed arrays
+ *   facets = entries.drilldown(["category", "tags"],
+ *                              :packed => true,
+ *                              :limit => 10)
+ *   keys, counts = facets["tags"]
+ *
+ * @overload drilldown(keys, options={})
+ *   @param keys [::Array<String, Groonga::Column>] The group keys.
+ *   @param options [::Hash] The name and value
+ *     pairs. Omitted names are initialized as the default value.
+ *   @option options [Boolean] :packed (false)
+ *     If it's `true`, each facet is returned as
+ *     `[keys, counts]` sorted by count in descending order.
+ *     Ties are sorted by key in ascending order. No grouped table
+ *     and no {Groonga::Record} are created for the result.
+ *   @option options [Integer] :limit (-1)
+ *     The max number of buckets in each facet. It's used only
+ *     with `:packed => true`. `-1` means all buckets.
+ *   @return [::Hash{Object => Groonga::Hash, ::Array}] Each key in
+ *     _keys_ and its grouped table or its packed `[keys, counts]`.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_table_drilldown (int argc, VALUE *argv, VALUE self)
+{
+    grn_ctx *context = NULL;
+    grn_obj *table;
+    int limit = -1;
+    grn_bool packed;
+    long i, n_keys;
+    grn_table_sort_key *keys;
+    grn_table_group_result *results;
+    DrilldownGroupData data;
+    uint64_t metrics_start;
+    VALUE rb_keys, rb_options, rb_limit, rb_packed;
+    VALUE rb_buckets_list;
+    VALUE rb_results;
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL,
+                             NULL, NULL, NULL,
+                             NULL);
+
+    rb_scan_args(argc, argv, "11", &rb_keys, &rb_options);
+
+    rb_grn_scan_options(rb_options,
+                        "packed", &rb_packed,
+                        "limit", &rb_limit,
+                        NULL);
+
+    rb_keys = rb_Array(rb_keys);
+    n_keys = RARRAY_LEN(rb_keys);
+    packed = RVAL2CBOOL(rb_packed);
+    if (!NIL_P(rb_limit))
+        limit = NUM2INT(rb_limit);
+
+    rb_results = rb_hash_new();
+    if (n_keys == 0)
+        return rb_results;
+
+    keys = ALLOCA_N(grn_table_sort_key, n_keys);
+    results = ALLOCA_N(grn_table_group_result, n_keys);
+    for (i = 0; i < n_keys; i++) {
+        VALUE rb_key, rb_resolved_key;
+
+        rb_key = RARRAY_AREF(rb_keys, i);
+        rb_resolved_key = rb_key;
+        if (RVAL2CBOOL(rb_obj_is_kind_of(rb_key, rb_cString)) ||
+            RVAL2CBOOL(rb_obj_is_kind_of(rb_key, rb_cSymbol))) {
+            rb_resolved_key = rb_grn_table_get_column(self,
+                                                      rb_obj_as_string(rb_key));
+            if (NIL_P(rb_resolved_key)) {
+                rb_raise(rb_eArgError,
+                         "unknown group key: <%s>: <%s>",
+                         rb_grn_inspect(rb_key),
+                         rb_grn_inspect(self));
+            }
+        }
+        keys[i].key = RVAL2GRNOBJECT(rb_resolved_key, &context);
+        keys[i].flags = 0;
+
+        results[i].table = NULL;
+        results[i].key_begin = i;
+        results[i].key_end = i;
+        results[i].limit = 1;
+        results[i].flags = GRN_TABLE_GROUP_CALC_COUNT;
+        results[i].op = GRN_OP_OR;
+        results[i].max_n_subrecs = 0;
+        results[i].calc_target = NULL;
+    }
+
+    data.context = context;
+    data.table = table;
+    data.keys = keys;
+    data.n_keys = n_keys;
+    data.results = results;
+    data.rc = GRN_SUCCESS;
+    metrics_start = RB_GRN_METRICS_START();
+    rb_thread_call_without_gvl(rb_grn_table_drilldown_group_without_gvl,
+                               &data, NULL, NULL);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_GROUP, metrics_start);
+
+    rb_buckets_list = rb_ary_new_capa(n_keys);
+    for (i = 0; i < n_keys; i++) {
+        rb_ary_push(rb_buckets_list,
+                    GRNOBJECT2RVAL(Qnil, context, results[i].table, GRN_TRUE));
+    }
+    rb_grn_context_check(context, self);
+    rb_grn_rc_check(data.rc, self);
+
+    for (i = 0; i < n_keys; i++) {
+        VALUE rb_key, rb_buckets;
+
+        rb_key = RARRAY_AREF(rb_keys, i);
+        rb_buckets = RARRAY_AREF(rb_buckets_list, i);
+        if (packed) {
+            VALUE rb_packed_buckets;
+            rb_packed_buckets = rb_grn_table_drilldown_pack(context,
+                                                            results[i].table,
+                                                            limit,
+                                                            self);
+            rb_grn_object_close(rb_buckets);
+            rb_hash_aset(rb_results, rb_key, rb_packed_buckets);
+        } else {
+            rb_hash_aset(rb_results, rb_key, rb_buckets);
+        }
+    }
+    RB_GC_GUARD(rb_buckets_list);
+
+    return rb_results;
+}
+
 /*
  * Iterates each sub records for the record _id_.
  *
@@ -1818,6 +2164,7 @@ rb_grn_table_set_value (VALUE self, VALUE rb_id, VALUE rb_value)
     rc = grn_obj_set_value(context, table, id, value, GRN_OBJ_SET);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_SET, table, id);
 
     return Qnil;
 }
@@ -2378,6 +2725,20 @@ rb_grn_table_locked_p (VALUE self)
  *
  *     参考: {Groonga::Expression#parse} .
  *
+ *     @option options [Boolean] :optimize (false)
+ *       If it's `true`, conditions joined by `&` are reordered by
+ *       their estimated number of matched records. Conditions that
+ *       can use indexes are evaluated first and the most selective
+ *       one is evaluated first. Other conditions are evaluated
+ *       later in the written order. The chosen order is available
+ *       as `result.expression.condition_plan`.
+ *
+ *       It isn't used when _expression_ is given.
+ *
+ *       See also {Groonga::ConditionPlan}.
+ *
+ *       @since 12.0.9
+ *
  * @overload select(query, options)
  *   _query_ には「[カラム名]:[演算子][値]」という書式で条件を
  *   指定する。演算子は以下の通り。
@@ -2415,8 +2776,9 @@ rb_grn_table_select (int argc, VALUE *argv, VALUE self)
     VALUE rb_query = Qnil, condition_or_options, options;
     VALUE rb_name, rb_operator, rb_result, rb_syntax;
     VALUE rb_allow_pragma, rb_allow_column, rb_allow_update, rb_allow_leading_not;
-    VALUE rb_default_column;
+    VALUE rb_default_column, rb_optimize;
     VALUE rb_expression = Qnil, builder;
+    uint64_t metrics_start;
 
     rb_scan_args(argc, argv, "02", &condition_or_options, &options);
 
@@ -2450,6 +2812,7 @@ rb_grn_table_select (int argc, VALUE *argv, VALUE self)
                         "allow_update", &rb_allow_update,
                         "allow_leading_not", &rb_allow_leading_not,
                         "default_column", &rb_default_column,
+                        "optimize", &rb_optimize,
                         NULL);
 
     if (!NIL_P(rb_operator))
@@ -2480,13 +2843,16 @@ rb_grn_table_select (int argc, VALUE *argv, VALUE self)
       rb_funcall(builder, rb_intern("allow_update="), 1, rb_allow_update);
       rb_funcall(builder, rb_intern("allow_leading_not="), 1, rb_allow_leading_not);
       rb_funcall(builder, rb_intern("default_column="), 1, rb_default_column);
+      rb_funcall(builder, rb_intern("optimize="), 1, rb_optimize);
       rb_expression = rb_grn_record_expression_builder_build(builder);
     }
     rb_grn_object_deconstruct(RB_GRN_OBJECT(RTYPEDDATA_DATA(rb_expression)),
                               &expression, NULL,
                               NULL, NULL, NULL, NULL);
 
+    metrics_start = RB_GRN_METRICS_START();
     grn_table_select(context, table, expression, result, operator);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_SELECT, metrics_start);
     rb_grn_context_check(context, self);
 
     rb_attr(rb_singleton_class(rb_result),
@@ -2714,6 +3080,7 @@ rb_grn_table_defrag (int argc, VALUE *argv, VALUE self)
     int n_segments;
     VALUE options, rb_threshold;
     int threshold = 0;
+    uint64_t metrics_start;
 
     rb_scan_args(argc, argv, "01", &options);
     rb_grn_scan_options(options,
@@ -2727,7 +3094,9 @@ rb_grn_table_defrag (int argc, VALUE *argv, VALUE self)
                              NULL, NULL, NULL,
                              NULL, NULL,
                              NULL);
+    metrics_start = RB_GRN_METRICS_START();
     n_segments = grn_obj_defrag(context, table, threshold);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_DEFRAG, metrics_start);
     rb_grn_context_check(context, self);
 
     return INT2NUM(n_segments);
@@ -2805,6 +3174,9 @@ rb_grn_table_load_arrow (VALUE self, VALUE rb_path)
     rc = grn_arrow_load(context, table, StringValueCStr(rb_path));
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    /* Loaded record IDs aren't reported by grn_arrow_load(). */
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_LOAD,
+                                 table, GRN_ID_NIL);
 
     return self;
 }
@@ -2974,6 +3346,7 @@ rb_grn_init_table (VALUE mGrn)
     rb_define_method(rb_cGrnTable, "sort", rb_grn_table_sort, -1);
     rb_define_method(rb_cGrnTable, "geo_sort", rb_grn_table_geo_sort, -1);
     rb_define_method(rb_cGrnTable, "group", rb_grn_table_group, -1);
+    rb_define_method(rb_cGrnTable, "drilldown", rb_grn_table_drilldown, -1);
 
     rb_define_method(rb_cGrnTable, "[]", rb_grn_table_array_reference, 1);
     rb_undef_method(rb_cGrnTable, "[]=");
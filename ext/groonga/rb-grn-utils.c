@@ -213,6 +213,11 @@ rb_grn_bulk_to_ruby_object_by_range_id (grn_ctx *context, grn_obj *bulk,
         int64_t time_value, sec, usec;
 
         time_value = GRN_TIME_VALUE(bulk);
+        if (rb_grn_context_get_value_mode(context) &
+            RB_GRN_VALUE_MODE_RAW_TIME) {
+            *rb_value = LL2NUM(time_value);
+            break;
+        }
         GRN_TIME_UNPACK(time_value, sec, usec);
         *rb_value = rb_funcall(rb_cTime, rb_intern("at"), 2,
                                LL2NUM(sec), LL2NUM(usec));
@@ -221,9 +226,17 @@ rb_grn_bulk_to_ruby_object_by_range_id (grn_ctx *context, grn_obj *bulk,
     case GRN_DB_SHORT_TEXT:
     case GRN_DB_TEXT:
     case GRN_DB_LONG_TEXT:
-        *rb_value = rb_grn_context_rb_string_new(context,
-                                                 GRN_TEXT_VALUE(bulk),
-                                                 GRN_TEXT_LEN(bulk));
+        if (rb_grn_context_get_value_mode(context) &
+            RB_GRN_VALUE_MODE_INTERNED_TEXT) {
+            *rb_value =
+                rb_grn_context_rb_interned_string_new(context,
+                                                      GRN_TEXT_VALUE(bulk),
+                                                      GRN_TEXT_LEN(bulk));
+        } else {
+            *rb_value = rb_grn_context_rb_string_new(context,
+                                                     GRN_TEXT_VALUE(bulk),
+                                                     GRN_TEXT_LEN(bulk));
+        }
         break;
     case GRN_DB_TOKYO_GEO_POINT: {
         int latitude, longitude;
@@ -271,6 +284,9 @@ rb_grn_bulk_to_ruby_object_by_range_type (grn_ctx *context, grn_obj *bulk,
         id = *((grn_id *)GRN_BULK_HEAD(bulk));
         if (id == GRN_ID_NIL) {
             *rb_value = Qnil;
+        } else if (rb_grn_context_get_value_mode(context) &
+                   RB_GRN_VALUE_MODE_RAW_REFERENCE) {
+            *rb_value = UINT2NUM(id);
         } else {
             VALUE rb_range;
 
@@ -860,14 +876,23 @@ rb_grn_uvector_to_ruby_object (grn_ctx *context, grn_obj *uvector,
     case GRN_TABLE_NO_KEY: {
         grn_id *current, *end;
         VALUE rb_range = Qnil;
+        grn_bool raw_reference;
         array = rb_ary_new();
-        rb_range = GRNTABLE2RVAL(context, range, GRN_FALSE);
+        raw_reference = (rb_grn_context_get_value_mode(context) &
+                         RB_GRN_VALUE_MODE_RAW_REFERENCE) != 0;
+        if (!raw_reference) {
+            rb_range = GRNTABLE2RVAL(context, range, GRN_FALSE);
+        }
         current = (grn_id *)GRN_BULK_HEAD(uvector);
         end = (grn_id *)GRN_BULK_CURR(uvector);
         while (current < end) {
             VALUE record = Qnil;
             if (*current != GRN_ID_NIL) {
-                record = rb_grn_record_new(rb_range, *current, Qnil);
+                if (raw_reference) {
+                    record = UINT2NUM(*current);
+                } else {
+                    record = rb_grn_record_new(rb_range, *current, Qnil);
+                }
             }
             rb_ary_push(array, record);
             current++;
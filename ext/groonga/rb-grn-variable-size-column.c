@@ -169,6 +169,7 @@ rb_grn_variable_size_column_array_reference (VALUE self, VALUE rb_id)
     VALUE rb_value;
     VALUE rb_range;
     unsigned int i, n;
+    uint64_t metrics_start;
 
     rb_grn_variable_size_column_deconstruct(SELF(self), &column, &context,
                                             NULL, NULL, &value, NULL,
@@ -184,7 +185,9 @@ rb_grn_variable_size_column_array_reference (VALUE self, VALUE rb_id)
     grn_obj_reinit(context, value,
                    value->header.domain,
                    value->header.flags | GRN_OBJ_VECTOR);
+    metrics_start = RB_GRN_METRICS_START();
     grn_obj_get_value(context, column, id, value);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_READ, metrics_start);
     rb_grn_context_check(context, self);
 
     rb_range = GRNTABLE2RVAL(context, range, GRN_FALSE);
@@ -389,6 +392,7 @@ rb_grn_variable_size_column_array_set (VALUE self, VALUE rb_id, VALUE rb_value)
     grn_id id;
     grn_obj *value, *element_value;
     int flags = GRN_OBJ_SET;
+    uint64_t metrics_start;
 
     rb_grn_variable_size_column_deconstruct(SELF(self), &column, &context,
                                             NULL, NULL, &value, &element_value,
@@ -458,13 +462,309 @@ rb_grn_variable_size_column_array_set (VALUE self, VALUE rb_id, VALUE rb_value)
                  rb_grn_inspect(rb_value));
     }
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_set_value(context, column, id, value, flags);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_WRITE, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_SET, column, id);
 
     return rb_value;
 }
 
+static grn_bool
+rb_grn_variable_size_column_is_text_vector (grn_obj *range)
+{
+    return range->header.type == GRN_TYPE &&
+        (range->header.flags & GRN_OBJ_KEY_VAR_SIZE);
+}
+
+static void
+rb_grn_variable_size_column_check_vector (VALUE self,
+                                          grn_ctx *context,
+                                          grn_obj *column)
+{
+    grn_column_flags flags;
+
+    flags = grn_column_get_flags(context, column);
+    if ((flags & GRN_OBJ_COLUMN_TYPE_MASK) != GRN_OBJ_COLUMN_VECTOR) {
+        rb_raise(rb_eArgError,
+                 "packed I/O is available only for vector column: <%s>",
+                 rb_grn_inspect(self));
+    }
+}
+
+static VALUE
+rb_grn_variable_size_column_to_binary (VALUE rb_object)
+{
+    ID id_to_binary;
+
+    if (NIL_P(rb_object) || RB_TYPE_P(rb_object, T_STRING))
+        return rb_object;
+
+    CONST_ID(id_to_binary, "to_binary");
+    if (rb_respond_to(rb_object, id_to_binary))
+        return rb_funcall(rb_object, id_to_binary, 0);
+
+    return rb_object;
+}
+
+/*
+ * Reads a vector column value for the record that ID is _id_ as
+ * packed buffers. No Ruby object is created for each element.
+ *
+ * @example Read a reference vector with weights
+ *   ids, weights = products.column("tags").read_packed(1)
+ *   ids.unpack("L*")     # => [1, 3]
+ *   weights.unpack("f*") # => [100.0, 10.0]
+ *
+ * @example Read an Int32 vector as Numo::Int32
+ *   values, _ = column.read_packed(1)
+ *   Numo::Int32.from_binary(values)
+ *
+ * @overload read_packed(id)
+ *   @param id [Integer, Groonga::Record] The record ID.
+ *   @return [::Array<String, nil>] `[values, weights]`.
+ *
+ *     `values` is a String that has elements in native byte
+ *     order for a vector of fixed size type such as `Int32` and
+ *     `Float`. It's a String of packed record IDs (`"L*"`) for a
+ *     reference vector. It's an `::Array` of String for a text
+ *     vector.
+ *
+ *     `weights` is a String of packed float32 (`"f*"`) weights in
+ *     the same order as `values`. It's `nil` when the column
+ *     isn't a weight vector column.
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_variable_size_column_read_packed (VALUE self, VALUE rb_id)
+{
+    grn_ctx *context = NULL;
+    grn_obj *column, *range;
+    grn_id range_id;
+    grn_column_flags flags;
+    grn_bool with_weight;
+    grn_id id;
+    grn_obj value;
+    VALUE rb_values;
+    VALUE rb_weights = Qnil;
+    uint64_t metrics_start;
+
+    rb_grn_variable_size_column_deconstruct(SELF(self), &column, &context,
+                                            NULL, NULL, NULL, NULL,
+                                            &range_id, &range);
+    rb_grn_variable_size_column_check_vector(self, context, column);
+
+    flags = grn_column_get_flags(context, column);
+    with_weight = (flags & GRN_OBJ_WITH_WEIGHT) ? GRN_TRUE : GRN_FALSE;
+    id = RVAL2GRNID(rb_id, context, range, self);
+
+    if (rb_grn_variable_size_column_is_text_vector(range)) {
+        GRN_TEXT_INIT(&value, GRN_OBJ_VECTOR);
+    } else {
+        GRN_VALUE_FIX_SIZE_INIT(&value,
+                                GRN_OBJ_VECTOR |
+                                (with_weight ? GRN_OBJ_WITH_WEIGHT : 0),
+                                range_id);
+    }
+    metrics_start = RB_GRN_METRICS_START();
+    grn_obj_get_value(context, column, id, &value);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_READ, metrics_start);
+    if (context->rc != GRN_SUCCESS) {
+        GRN_OBJ_FIN(context, &value);
+        rb_grn_context_check(context, self);
+    }
+
+    if (value.header.type == GRN_VECTOR) {
+        unsigned int i, n;
+        n = grn_vector_size(context, &value);
+        rb_values = rb_ary_new2(n);
+        if (with_weight)
+            rb_weights = rb_str_buf_new(sizeof(float) * n);
+        for (i = 0; i < n; i++) {
+            const char *element;
+            unsigned int element_size;
+            float weight = 0.0;
+            element_size = grn_vector_get_element_float(context, &value, i,
+                                                        &element, &weight,
+                                                        NULL);
+            rb_ary_push(rb_values, rb_str_new(element, element_size));
+            if (with_weight)
+                rb_str_buf_cat(rb_weights, (const char *)&weight,
+                               sizeof(float));
+        }
+    } else if (with_weight) {
+        unsigned int i, n;
+        n = grn_uvector_size(context, &value);
+        rb_values = rb_str_buf_new(sizeof(grn_id) * n);
+        rb_weights = rb_str_buf_new(sizeof(float) * n);
+        for (i = 0; i < n; i++) {
+            grn_id element_id;
+            float weight = 0.0;
+            element_id = grn_uvector_get_element_record(context, &value, i,
+                                                        &weight);
+            rb_str_buf_cat(rb_values, (const char *)&element_id,
+                           sizeof(grn_id));
+            rb_str_buf_cat(rb_weights, (const char *)&weight, sizeof(float));
+        }
+    } else {
+        rb_values = rb_str_new(GRN_BULK_HEAD(&value), GRN_BULK_VSIZE(&value));
+    }
+    GRN_OBJ_FIN(context, &value);
+
+    return rb_ary_new_from_args(2, rb_values, rb_weights);
+}
+
+/*
+ * Writes a vector column value for the record that ID is _id_
+ * from packed buffers. It's the counterpart of {#read_packed}.
+ *
+ * @example Write a reference vector with weights
+ *   tags = products.column("tags")
+ *   tags.write_packed(1, [1, 3].pack("L*"), [100, 10].pack("f*"))
+ *
+ * @example Write a Float vector from Numo::DFloat
+ *   column.write_packed(1, Numo::DFloat[0.1, 0.2, 0.3])
+ *
+ * @overload write_packed(id, values, weights=nil)
+ *   @param id [Integer, Groonga::Record] The record ID.
+ *   @param values [String, ::Array<String>, #to_binary] The
+ *     elements. It must be the same form as `values` returned by
+ *     {#read_packed}. An object that responds to `to_binary` such
+ *     as `Numo::NArray` is also accepted.
+ *   @param weights [String, #to_binary, nil] The packed float32
+ *     weights. It's only for a weight vector column. Omitted
+ *     weights are `0`.
+ *   @return [void]
+ *
+ * @since 12.0.9
+ */
+static VALUE
+rb_grn_variable_size_column_write_packed (int argc, VALUE *argv, VALUE self)
+{
+    grn_ctx *context = NULL;
+    grn_obj *column, *range;
+    grn_id range_id;
+    grn_column_flags flags;
+    grn_bool with_weight;
+    grn_id id;
+    grn_obj value;
+    VALUE rb_id, rb_values, rb_weights;
+    const float *weights = NULL;
+    long i, n_elements, n_weights = 0;
+    grn_rc rc;
+    uint64_t metrics_start;
+
+    rb_scan_args(argc, argv, "21", &rb_id, &rb_values, &rb_weights);
+
+    rb_grn_variable_size_column_deconstruct(SELF(self), &column, &context,
+                                            NULL, NULL, NULL, NULL,
+                                            &range_id, &range);
+    rb_grn_variable_size_column_check_vector(self, context, column);
+
+    flags = grn_column_get_flags(context, column);
+    with_weight = (flags & GRN_OBJ_WITH_WEIGHT) ? GRN_TRUE : GRN_FALSE;
+    id = RVAL2GRNID(rb_id, context, range, self);
+
+    rb_values = rb_grn_variable_size_column_to_binary(rb_values);
+    rb_weights = rb_grn_variable_size_column_to_binary(rb_weights);
+    if (!NIL_P(rb_weights)) {
+        if (!with_weight) {
+            rb_raise(rb_eArgError,
+                     "weights are available only for weight vector column: "
+                     "<%s>",
+                     rb_grn_inspect(self));
+        }
+        StringValue(rb_weights);
+        if ((RSTRING_LEN(rb_weights) % sizeof(float)) != 0) {
+            rb_raise(rb_eArgError,
+                     "weights must be packed float32: <%ld> bytes",
+                     RSTRING_LEN(rb_weights));
+        }
+        weights = (const float *)RSTRING_PTR(rb_weights);
+        n_weights = RSTRING_LEN(rb_weights) / sizeof(float);
+    }
+
+    if (rb_grn_variable_size_column_is_text_vector(range)) {
+        VALUE rb_elements = rb_ary_to_ary(rb_values);
+        n_elements = RARRAY_LEN(rb_elements);
+        rb_values = rb_ary_new_capa(n_elements);
+        for (i = 0; i < n_elements; i++) {
+            VALUE rb_element = RARRAY_AREF(rb_elements, i);
+            StringValue(rb_element);
+            rb_ary_push(rb_values, rb_element);
+        }
+        RB_GC_GUARD(rb_elements);
+    } else {
+        long element_size;
+        if (with_weight && !grn_obj_is_table(context, range)) {
+            rb_raise(rb_eArgError,
+                     "packed weight vector is available only for "
+                     "reference or text vector column: <%s>",
+                     rb_grn_inspect(self));
+        }
+        StringValue(rb_values);
+        if (grn_obj_is_table(context, range)) {
+            element_size = sizeof(grn_id);
+        } else {
+            element_size = grn_obj_get_range(context, range);
+        }
+        if ((RSTRING_LEN(rb_values) % element_size) != 0) {
+            rb_raise(rb_eArgError,
+                     "values size must be a multiple of element size <%ld>: "
+                     "<%ld>",
+                     element_size,
+                     RSTRING_LEN(rb_values));
+        }
+        n_elements = RSTRING_LEN(rb_values) / element_size;
+    }
+    if (weights && n_weights != n_elements) {
+        rb_raise(rb_eArgError,
+                 "the number of weights must be the same as "
+                 "the number of values: <%ld>: <%ld>",
+                 n_weights, n_elements);
+    }
+
+    if (rb_grn_variable_size_column_is_text_vector(range)) {
+        GRN_TEXT_INIT(&value, GRN_OBJ_VECTOR);
+        for (i = 0; i < n_elements; i++) {
+            VALUE rb_element = RARRAY_AREF(rb_values, i);
+            grn_vector_add_element_float(context, &value,
+                                         RSTRING_PTR(rb_element),
+                                         RSTRING_LEN(rb_element),
+                                         weights ? weights[i] : 0.0,
+                                         range_id);
+        }
+    } else if (with_weight) {
+        const grn_id *ids = (const grn_id *)RSTRING_PTR(rb_values);
+        GRN_VALUE_FIX_SIZE_INIT(&value,
+                                GRN_OBJ_VECTOR | GRN_OBJ_WITH_WEIGHT,
+                                range_id);
+        for (i = 0; i < n_elements; i++) {
+            grn_uvector_add_element_record(context, &value, ids[i],
+                                           weights ? weights[i] : 0.0);
+        }
+    } else {
+        GRN_VALUE_FIX_SIZE_INIT(&value, GRN_OBJ_VECTOR, range_id);
+        grn_bulk_write(context, &value,
+                       RSTRING_PTR(rb_values), RSTRING_LEN(rb_values));
+    }
+
+    metrics_start = RB_GRN_METRICS_START();
+    rc = grn_obj_set_value(context, column, id, &value, GRN_OBJ_SET);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_COLUMN_WRITE, metrics_start);
+    GRN_OBJ_FIN(context, &value);
+    rb_grn_context_check(context, self);
+    rb_grn_rc_check(rc, self);
+    rb_grn_context_record_change(context, RB_GRN_CHANGE_SET, column, id);
+    RB_GC_GUARD(rb_values);
+    RB_GC_GUARD(rb_weights);
+
+    return Qnil;
+}
+
 /*
  * Returns whether the column is compressed or not. If
  * @type@ is specified, it returns whether the column is
@@ -572,6 +872,7 @@ rb_grn_variable_size_column_defrag (int argc, VALUE *argv, VALUE self)
     int n_segments;
     VALUE options, rb_threshold;
     int threshold = 0;
+    uint64_t metrics_start;
 
     rb_scan_args(argc, argv, "01", &options);
     rb_grn_scan_options(options,
@@ -585,7 +886,9 @@ rb_grn_variable_size_column_defrag (int argc, VALUE *argv, VALUE self)
     rb_grn_object_deconstruct(RB_GRN_OBJECT(rb_grn_column), &column, &context,
                               NULL, NULL,
                               NULL, NULL);
+    metrics_start = RB_GRN_METRICS_START();
     n_segments = grn_obj_defrag(context, column, threshold);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_DEFRAG, metrics_start);
     rb_grn_context_check(context, self);
 
     return INT2NUM(n_segments);
@@ -659,12 +962,15 @@ rb_grn_variable_size_column_reindex (VALUE self)
     grn_rc rc;
     grn_ctx *context;
     grn_obj *column;
+    uint64_t metrics_start;
 
     rb_grn_variable_size_column_deconstruct(SELF(self), &column, &context,
                                             NULL, NULL, NULL, NULL,
                                             NULL, NULL);
 
+    metrics_start = RB_GRN_METRICS_START();
     rc = grn_obj_reindex(context, column);
+    RB_GRN_METRICS_STOP(context, RB_GRN_METRICS_REINDEX, metrics_start);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
 
@@ -682,6 +988,11 @@ rb_grn_init_variable_size_column (VALUE mGrn)
     rb_define_method(rb_cGrnVariableSizeColumn, "[]=",
                      rb_grn_variable_size_column_array_set, 2);
 
+    rb_define_method(rb_cGrnVariableSizeColumn, "read_packed",
+                     rb_grn_variable_size_column_read_packed, 1);
+    rb_define_method(rb_cGrnVariableSizeColumn, "write_packed",
+                     rb_grn_variable_size_column_write_packed, -1);
+
     rb_define_method(rb_cGrnVariableSizeColumn, "compressed?",
                      rb_grn_variable_size_column_compressed_p, -1);
     rb_define_method(rb_cGrnVariableSizeColumn, "defrag",
@@ -111,12 +111,51 @@ RB_GRN_BEGIN_DECLS
 
 typedef void (*RbGrnUnbindFunction) (void *object);
 
+typedef enum {
+    RB_GRN_METRICS_SELECT,
+    RB_GRN_METRICS_SORT,
+    RB_GRN_METRICS_GROUP,
+    RB_GRN_METRICS_COLUMN_READ,
+    RB_GRN_METRICS_COLUMN_WRITE,
+    RB_GRN_METRICS_ADD,
+    RB_GRN_METRICS_DELETE,
+    RB_GRN_METRICS_REINDEX,
+    RB_GRN_METRICS_DEFRAG,
+    RB_GRN_METRICS_N_OPERATIONS
+} RbGrnMetricsOperation;
+
+typedef struct _RbGrnMetrics RbGrnMetrics;
+
+typedef struct _RbGrnMemoryPool RbGrnMemoryPool;
+
+typedef enum {
+    RB_GRN_VALUE_MODE_RAW_TIME      = (1 << 0),
+    RB_GRN_VALUE_MODE_INTERNED_TEXT = (1 << 1),
+    RB_GRN_VALUE_MODE_RAW_REFERENCE = (1 << 2)
+} RbGrnValueMode;
+
+typedef enum {
+    RB_GRN_CHANGE_ADD       = 1,
+    RB_GRN_CHANGE_DELETE    = 2,
+    RB_GRN_CHANGE_SET       = 3,
+    RB_GRN_CHANGE_INCREMENT = 4,
+    RB_GRN_CHANGE_LOAD      = 5
+} RbGrnChangeType;
+
 typedef struct _RbGrnContext RbGrnContext;
 struct _RbGrnContext
 {
     grn_ctx *context;
     grn_ctx context_entity;
     grn_hash *floating_objects;
+    RbGrnMetrics *metrics;
+    RbGrnMemoryPool *memory_pool;
+    grn_bool defer_release;
+    struct _RbGrnObject *deferred_objects;
+    unsigned int n_deferred_objects;
+    unsigned int value_mode;
+    VALUE change_log;
+    VALUE record_identity_map;
     VALUE self;
 };
 
@@ -134,6 +173,7 @@ struct _RbGrnObject
     grn_bool need_close;
     grn_bool have_finalizer;
     grn_bool floating;
+    RbGrnObject *next_deferred;
 };
 
 typedef struct _RbGrnNamedObject RbGrnNamedObject;
@@ -255,6 +295,7 @@ struct _RbGrnColumnCache
 };
 
 RB_GRN_VAR grn_bool rb_grn_exited;
+RB_GRN_VAR grn_bool rb_grn_metrics_enabled;
 
 RB_GRN_VAR VALUE rb_eGrnError;
 RB_GRN_VAR VALUE rb_eGrnClosed;
@@ -313,6 +354,7 @@ RB_GRN_VAR VALUE rb_mGrnRequestCanceler;
 RB_GRN_VAR VALUE rb_mGrnRequestTimer;
 RB_GRN_VAR VALUE rb_cGrnRequestTimerID;
 RB_GRN_VAR VALUE rb_cGrnColumnCache;
+RB_GRN_VAR VALUE rb_cGrnBitmap;
 
 RB_GRN_VAR rb_data_type_t rb_grn_object_data_type;
 
@@ -379,6 +421,8 @@ void           rb_grn_init_id                       (VALUE mGrn);
 void           rb_grn_init_name                     (VALUE mGrn);
 void           rb_grn_init_default_cache            (VALUE mGrn);
 void           rb_grn_init_column_cache             (VALUE mGrn);
+void           rb_grn_init_metrics                  (VALUE mGrn);
+void           rb_grn_init_bitmap                   (VALUE mGrn);
 
 VALUE          rb_grn_rc_to_exception               (grn_rc rc);
 void           rb_grn_rc_check                      (grn_rc rc,
@@ -404,6 +448,18 @@ grn_obj       *rb_grn_context_get_backward_compatibility
                                                      unsigned int name_size);
 void           rb_grn_context_object_created        (VALUE rb_context,
                                                      VALUE rb_object);
+grn_bool       rb_grn_context_defer_object_release  (RbGrnObject *rb_grn_object);
+void           rb_grn_context_release_deferred_object
+                                                    (grn_ctx *context,
+                                                     grn_obj *object);
+
+uint64_t       rb_grn_metrics_now                   (void);
+void           rb_grn_metrics_record                (grn_ctx *context,
+                                                     RbGrnMetricsOperation operation,
+                                                     uint64_t start);
+void           rb_grn_metrics_free                  (RbGrnMetrics *metrics);
+void           rb_grn_metrics_reset                 (RbGrnMetrics *metrics);
+VALUE          rb_grn_metrics_to_ruby_object        (RbGrnMetrics *metrics);
 
 const char    *rb_grn_inspect                       (VALUE object);
 void           rb_grn_scan_options                  (VALUE options, ...)
@@ -426,6 +482,9 @@ void           rb_grn_object_bind                   (VALUE self,
                                                      grn_ctx *context,
                                                      grn_obj *object);
 void           rb_grn_object_free                   (RbGrnObject *rb_grn_object);
+void           rb_grn_object_release                (RbGrnObject *rb_grn_object);
+void           rb_grn_object_release_deferred       (RbGrnObject *rb_grn_object,
+                                                     grn_bool owner);
 void           rb_grn_object_assign                 (VALUE klass,
                                                      VALUE self,
                                                      VALUE rb_context,
@@ -649,6 +708,8 @@ VALUE          rb_grn_record_new                    (VALUE table,
 VALUE          rb_grn_record_new_added              (VALUE table,
                                                      grn_id id,
                                                      VALUE values);
+void           rb_grn_record_reset_id               (VALUE record,
+                                                     grn_id id);
 VALUE          rb_grn_record_new_raw                (VALUE table,
                                                      VALUE id,
                                                      VALUE values);
@@ -669,6 +730,14 @@ VALUE          rb_grn_index_new                     (VALUE rb_index_column,
 
 #define RB_GRN_INTERN(c_string)       (rb_to_symbol(rb_str_new_cstr(c_string)))
 
+#define RB_GRN_METRICS_START()                                          \
+    (rb_grn_metrics_enabled ? rb_grn_metrics_now() : 0)
+#define RB_GRN_METRICS_STOP(context, operation, start)                  \
+    do {                                                                \
+        if ((start) > 0)                                                \
+            rb_grn_metrics_record((context), (operation), (start));     \
+    } while (0)
+
 #define RVAL2CBOOL(object)            (RTEST(object))
 #define CBOOL2RVAL(boolean)           ((boolean) ? Qtrue : Qfalse)
 
@@ -787,6 +856,17 @@ VALUE          rb_grn_context_to_ruby_object        (grn_ctx *context);
 VALUE          rb_grn_context_rb_string_new         (grn_ctx *context,
                                                      const char *string,
                                                      long length);
+VALUE          rb_grn_context_rb_interned_string_new(grn_ctx *context,
+                                                     const char *string,
+                                                     long length);
+unsigned int   rb_grn_context_get_value_mode        (grn_ctx *context);
+VALUE          rb_grn_context_get_record_identity_map
+                                                    (grn_ctx *context);
+grn_bool       rb_grn_context_is_recording_changes  (grn_ctx *context);
+void           rb_grn_context_record_change         (grn_ctx *context,
+                                                     RbGrnChangeType type,
+                                                     grn_obj *object,
+                                                     grn_id id);
 VALUE          rb_grn_context_rb_string_encode      (grn_ctx *context,
                                                      VALUE rb_string);
 void           rb_grn_context_text_set              (grn_ctx *context,
@@ -262,4 +262,6 @@ Init_groonga (void)
     rb_grn_init_name(mGrn);
     rb_grn_init_default_cache(mGrn);
     rb_grn_init_column_cache(mGrn);
+    rb_grn_init_metrics(mGrn);
+    rb_grn_init_bitmap(mGrn);
 }
@@ -94,8 +94,10 @@ end
 require "groonga/context"
 require "groonga/database"
 require "groonga/column"
+require "groonga/fix-size-column"
 require "groonga/patricia-trie"
 require "groonga/index-column"
+require "groonga/expression"
 require "groonga/dumper"
 require "groonga/database-inspector"
 require "groonga/schema"
@@ -103,3 +105,12 @@ require "groonga/pagination"
 require "groonga/grntest-log"
 require "groonga/logger"
 require "groonga/query-logger"
+require "groonga/query-cache"
+require "groonga/lexicon-builder"
+require "groonga/bitmap"
+require "groonga/residency-manager"
+require "groonga/schema-catalog"
+require "groonga/fork-support"
+require "groonga/change-log"
+require "groonga/backup"
+require "groonga/flush-scheduler"
@@ -0,0 +1,337 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "digest/sha2"
+require "fileutils"
+require "json"
+
+module Groonga
+  # It copies files of a quiesced database to a backup directory.
+  # See {Groonga::Database#backup}.
+  #
+  # @since 12.0.9
+  class Backup
+    # It's raised when files in a backup directory don't match its
+    # manifest.
+    class BrokenBackup < Groonga::Error
+      # @return [::Array<String>] The paths of broken files.
+      attr_reader :paths
+      def initialize(backup_dir, paths)
+        @paths = paths
+        super("broken backup: <#{backup_dir}>: #{paths.inspect}")
+      end
+    end
+
+    # The result of {Groonga::Database#backup}.
+    class Report < Struct.new(:manifest_path,
+                              :n_copied_files,
+                              :n_linked_files,
+                              :n_copied_bytes,
+                              :skipped_paths,
+                              :elapsed_time)
+    end
+
+    MANIFEST_NAME = "manifest.json"
+    FORMAT_VERSION = 1
+
+    class << self
+      # Checks files in a backup directory by its manifest.
+      #
+      # @param backup_dir [String] The backup directory.
+      # @return [::Array<String>] The paths of missing or broken
+      #   files. It's empty when the backup is valid.
+      def verify(backup_dir)
+        manifest = load_manifest(backup_dir)
+        manifest["files"].reject do |file|
+          path = File.join(backup_dir, file["path"])
+          File.file?(path) and
+            File.size(path) == file["size"] and
+            (file["sha256"].nil? or
+             Digest::SHA256.file(path).hexdigest == file["sha256"])
+        end.collect do |file|
+          file["path"]
+        end
+      end
+
+      # Restores a database from a backup directory. The backup is
+      # verified before any file is restored.
+      #
+      # The database refers objects created with an explicit path
+      # such as `:path` and `:named_path` by their original paths. A
+      # backup that has such objects can be restored only to the
+      # original database path. Otherwise, the restored database
+      # would use the files of the original database.
+      #
+      # @param backup_dir [String] The backup directory.
+      # @param database_path [String] The path of the restored
+      #   database. It must not exist.
+      # @raise [Groonga::Backup::BrokenBackup] If the backup is broken.
+      # @raise [ArgumentError] If the backup has objects with their
+      #   own paths and _database_path_ isn't the original path.
+      # @return [void]
+      def restore(backup_dir, database_path)
+        if File.exist?(database_path)
+          raise ArgumentError, "database already exists: <#{database_path}>"
+        end
+        manifest = load_manifest(backup_dir)
+        database_name = manifest["database"]
+        external_paths = manifest["files"].reject do |file|
+          file["default_path"]
+        end.collect do |file|
+          file["path"]
+        end
+        original_path = manifest["database_path"]
+        unless external_paths.empty?
+          if original_path.nil? or
+              File.expand_path(database_path) != original_path
+            raise ArgumentError,
+                  "backup that has objects with their own paths can be " +
+                  "restored only to the original path: " +
+                  "<#{original_path}>: #{external_paths.inspect}"
+          end
+        end
+        broken_paths = verify(backup_dir)
+        raise BrokenBackup.new(backup_dir, broken_paths) unless broken_paths.empty?
+
+        output_dir = File.dirname(database_path)
+        output_name = File.basename(database_path)
+        manifest["files"].each do |file|
+          path = file["path"]
+          if path.start_with?(database_name)
+            output_path = File.join(output_dir,
+                                    output_name + path[database_name.size..-1])
+          else
+            output_path = File.join(output_dir, path)
+          end
+          FileUtils.mkdir_p(File.dirname(output_path))
+          copy_file(File.join(backup_dir, path), output_path)
+        end
+      end
+
+      # @private
+      def load_manifest(backup_dir)
+        JSON.parse(File.read(File.join(backup_dir, MANIFEST_NAME)))
+      end
+
+      # @private
+      def copy_file(input_path, output_path)
+        File.open(input_path, "rb") do |input|
+          File.open(output_path, "wb") do |output|
+            # It uses copy_file_range(2) when it's available. It
+            # shares extents on file systems that support reflink.
+            IO.copy_stream(input, output)
+          end
+        end
+      end
+    end
+
+    # @private
+    def initialize(database, backup_dir, options={})
+      @database = database
+      @context = database.context
+      @backup_dir = backup_dir
+      @incremental_from = options[:incremental_from]
+      @lock_timeout = options[:lock_timeout] || 0
+      @checksum = options.fetch(:checksum, true)
+    end
+
+    # @private
+    def run
+      start_time = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      manifest_path = File.join(@backup_dir, MANIFEST_NAME)
+      if File.exist?(manifest_path)
+        raise ArgumentError, "backup already exists: <#{@backup_dir}>"
+      end
+      previous_manifest = nil
+      if @incremental_from
+        previous_manifest = self.class.load_manifest(@incremental_from)
+      end
+      previous_files = {}
+      if previous_manifest
+        previous_manifest["files"].each do |file|
+          previous_files[file["path"]] = file
+        end
+      end
+
+      FileUtils.mkdir_p(@backup_dir)
+      report = Report.new(manifest_path, 0, 0, 0, [], nil)
+      created_at = Time.now
+      files = []
+      @database.lock(:timeout => @lock_timeout) do
+        @database.flush
+        collect_files(report).each do |path, entry|
+          relative_path = path[(database_dir.size + 1)..-1]
+          previous_file = previous_files[relative_path]
+          stat = File.stat(path)
+          output_path = File.join(@backup_dir, relative_path)
+          FileUtils.mkdir_p(File.dirname(output_path))
+          copied = changed?(stat, previous_file, previous_manifest, entry)
+          if copied
+            self.class.copy_file(path, output_path)
+            report.n_copied_files += 1
+            report.n_copied_bytes += stat.size
+            digest = compute_digest(output_path)
+          else
+            link_file(File.join(@incremental_from, relative_path), output_path)
+            report.n_linked_files += 1
+            digest = previous_file["sha256"]
+          end
+          files << {
+            "path" => relative_path,
+            "object" => entry ? entry.name : nil,
+            "size" => stat.size,
+            "mtime" => stat.mtime.to_i * 1_000_000_000 + stat.mtime.nsec,
+            "sha256" => digest,
+            "copied" => copied,
+            "default_path" => default_path?(entry),
+          }
+        end
+      end
+
+      manifest = {
+        "format_version" => FORMAT_VERSION,
+        "database" => File.basename(@database.path),
+        "database_path" => File.expand_path(@database.path),
+        "created_at" => created_at.to_i,
+        "incremental_from" => @incremental_from,
+        "groonga_version" => Groonga.version,
+        "files" => files,
+      }
+      File.open("#{manifest_path}.tmp", "w") do |output|
+        output.write(JSON.pretty_generate(manifest))
+      end
+      File.rename("#{manifest_path}.tmp", manifest_path)
+      report.elapsed_time =
+        Process.clock_gettime(Process::CLOCK_MONOTONIC) - start_time
+      report
+    end
+
+    private
+    def database_dir
+      @database_dir ||= File.dirname(File.expand_path(@database.path))
+    end
+
+    def collect_files(report)
+      files = {}
+      database_path = File.expand_path(@database.path)
+      Dir.glob("#{database_path}{,.*}").each do |path|
+        if File.directory?(path)
+          Dir.glob("#{path}/**/*").each do |sub_path|
+            files[sub_path] = nil if File.file?(sub_path)
+          end
+        else
+          files[path] = nil
+        end
+      end
+      @database.catalog.each do |entry|
+        next if entry.path.nil?
+        Dir.glob("#{File.expand_path(entry.path)}{,.*}").each do |path|
+          if path.start_with?("#{database_dir}/")
+            files[path] = entry
+          else
+            report.skipped_paths << path
+          end
+        end
+      end
+      files.sort_by {|path, _| path}
+    end
+
+    # Groonga stores the path of an object created with an explicit
+    # path such as `:path` or `:named_path`. An object without it
+    # uses `#{database_path}.#{ID in 7 hex digits}`. Such paths are
+    # resolved from the database path when the database is opened.
+    def default_path?(entry)
+      return true if entry.nil?
+      default_path = "%s.%07X" % [File.expand_path(@database.path), entry.id]
+      File.expand_path(entry.path).casecmp(default_path).zero?
+    end
+
+    def changed?(stat, previous_file, previous_manifest, entry)
+      return true if previous_file.nil?
+      return true if stat.size != previous_file["size"]
+      mtime = stat.mtime.to_i * 1_000_000_000 + stat.mtime.nsec
+      return true if mtime != previous_file["mtime"]
+      # Files of the database itself are small. They're always copied.
+      return true if entry.nil?
+      # Objects that aren't opened in this process weren't changed by
+      # this process. Their files are already synchronized.
+      return false unless entry.opened?
+      object = @context[entry.name]
+      return true if object.nil?
+      # last_modified has only second resolution.
+      object.last_modified.to_i >= previous_manifest["created_at"]
+    end
+
+    def link_file(input_path, output_path)
+      File.link(input_path, output_path)
+    rescue SystemCallError
+      self.class.copy_file(input_path, output_path)
+    end
+
+    def compute_digest(path)
+      return nil unless @checksum
+      Digest::SHA256.file(path).hexdigest
+    end
+  end
+
+  class Database
+    # Backs up files of the database to _backup_dir_ without closing
+    # the database. It's a quiesced backup, not an online hot backup:
+    # the backup is consistent only when no one writes to the
+    # database until it finishes.
+    #
+    # The database is locked by {#lock} and all opened objects are
+    # flushed by {Groonga::Flushable#flush} before files are
+    # copied. The lock is held until all files are copied. The lock
+    # only excludes code that locks the database such as another
+    # backup. It doesn't exclude writers such as {Groonga::Table#add}
+    # and {Groonga::Column#[]=}. Your application must stop them
+    # before calling this method and resume them after it returns.
+    # Readers can keep running.
+    #
+    # With `:incremental_from`, only files that are changed after the
+    # previous backup are copied. Other files are hard linked from
+    # the previous backup. A file is changed when its size or mtime
+    # is changed or the {Groonga::Object#last_modified} of its object
+    # opened in this process is newer than the previous backup. So
+    # each backup directory is a complete backup.
+    #
+    # `manifest.json` in _backup_dir_ lists backed up files with
+    # their sizes and SHA-256 digests. It's written at last. A backup
+    # directory without it is incomplete. Use {Groonga::Backup.verify}
+    # and {Groonga::Backup.restore} to use the backup.
+    #
+    # @example Take a full backup then an incremental backup
+    #   database.backup("backup/full")
+    #   database.backup("backup/day1", :incremental_from => "backup/full")
+    #
+    # @param backup_dir [String] The backup directory. It must not
+    #   have a backup.
+    # @param options [::Hash]
+    # @option options [String, nil] :incremental_from (nil) The
+    #   previous backup directory.
+    # @option options [Integer] :lock_timeout (0) The timeout to
+    #   acquire the lock. See {#lock}.
+    # @option options [Boolean] :checksum (true) Whether SHA-256
+    #   digests of copied files are computed for verification.
+    # @return [Groonga::Backup::Report] The numbers of copied and
+    #   linked files, copied bytes, paths of files outside of the
+    #   database directory that aren't backed up and the elapsed
+    #   time in seconds.
+    #
+    # @since 12.0.9
+    def backup(backup_dir, options={})
+      Backup.new(self, backup_dir, options).run
+    end
+  end
+end
@@ -0,0 +1,86 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  class Bitmap
+    # Selects records in the bitmap from _table_. It's not
+    # `Enumerable#select`.
+    #
+    # @example Select books in stock
+    #   in_stock = Groonga::Bitmap.from_table(stocks.select {...})
+    #   books = in_stock.select_records(products) do |record|
+    #     record.type == "book"
+    #   end
+    #
+    # @param table [Groonga::Table] The table that has records.
+    # @return [Groonga::Hash] The result table. It's the result of
+    #   {#to_table} narrowed by the condition.
+    # @see Groonga::Table#select
+    def select_records(table, *args, &block)
+      if args.last.is_a?(::Hash)
+        options = args.pop.dup
+      else
+        options = {}
+      end
+      options[:result] = to_table(table)
+      options[:operator] = Operator::AND
+      table.select(*args, options, &block)
+    end
+
+    # Sorts records in the bitmap. It's not `Enumerable#sort`.
+    #
+    # @param table [Groonga::Table] The table that has records.
+    # @return [::Array<Groonga::Record>] The sorted records of _table_.
+    # @see Groonga::Table#sort
+    def sort_records(table, *args, &block)
+      result = to_table(table)
+      begin
+        sorted = result.sort(*args, &block)
+        begin
+          sorted.collect do |record|
+            record.value.key
+          end
+        ensure
+          sorted.close
+        end
+      ensure
+        result.close
+      end
+    end
+
+    # Groups records in the bitmap.
+    #
+    # @param table [Groonga::Table] The table that has records.
+    # @return [Groonga::Hash] The grouped result table. Sub records
+    #   of it refer {#to_table} result. So {#to_table} result isn't
+    #   closed.
+    # @see Groonga::Table#group
+    def group_records(table, *args, &block)
+      to_table(table).group(*args, &block)
+    end
+
+    def inspect
+      "#<#{self.class.name} size: <#{size}>, memory_size: <#{memory_size}>>"
+    end
+  end
+
+  class Table
+    # @return [Groonga::Bitmap] A new bitmap that has IDs of records
+    #   in the table. See {Groonga::Bitmap.from_table} for details.
+    #
+    # @since 12.0.9
+    def to_bitmap
+      Bitmap.from_table(self)
+    end
+  end
+end
@@ -0,0 +1,246 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # It records changes made through a context. Set it to
+  # {Groonga::Context#change_log=} to start recording.
+  #
+  # Each change is a compact fixed size binary entry that has the
+  # changed table ID, record ID and column ID. Values aren't
+  # recorded. Read the current values from the database when you
+  # apply changes.
+  #
+  # Changes are appended to a file when `:path` is specified.
+  # {Groonga::ChangeLog::Reader} reads the file incrementally from
+  # other processes. Otherwise, the last `:capacity` changes are kept
+  # in memory.
+  #
+  # @example Record changes into a file and tail them
+  #   context.change_log = Groonga::ChangeLog.new(:path => "db/changes.log")
+  #
+  #   # In another process
+  #   reader = Groonga::ChangeLog::Reader.new("db/changes.log")
+  #   reader.follow do |entry|
+  #     p [entry.type, context[entry.table_id].name, entry.record_id]
+  #   end
+  #
+  # @since 12.0.9
+  class ChangeLog
+    # The types of changes.
+    TYPES = {
+      1 => :add,
+      2 => :delete,
+      3 => :set,
+      4 => :increment,
+      5 => :load,
+    }
+
+    # @private
+    ENTRY_FORMAT = "Q<q<Cx3L<L<L<"
+    # The size of an entry in bytes.
+    ENTRY_SIZE = 32
+
+    # It's raised when an entry in a log file isn't the next entry
+    # or when entries in memory that aren't read yet are overwritten.
+    class BrokenLog < Groonga::Error
+    end
+
+    # A recorded change. `column_id` is `0` for changes of records
+    # such as `:add` and `:delete`. `record_id` is `0` for `:load`
+    # because IDs of loaded records aren't known.
+    class Entry < Struct.new(:sequence,
+                             :time,
+                             :type,
+                             :table_id,
+                             :record_id,
+                             :column_id)
+      class << self
+        # @private
+        def unpack(data)
+          sequence, time, type, table_id, record_id, column_id =
+            data.unpack(ENTRY_FORMAT)
+          new(sequence,
+              Time.at(time / 1_000_000, time % 1_000_000),
+              TYPES[type],
+              table_id,
+              record_id,
+              column_id)
+        end
+      end
+
+      # @private
+      def pack
+        time_value = time.to_i * 1_000_000 + time.usec
+        type_value = TYPES.key(type)
+        [sequence, time_value, type_value, table_id, record_id, column_id].
+          pack(ENTRY_FORMAT)
+      end
+    end
+
+    # @return [String, nil] The path of the log file.
+    attr_reader :path
+    # @return [Integer, nil] The max number of entries kept in memory.
+    attr_reader :capacity
+    # @return [Integer] The sequence number of the last entry.
+    attr_reader :sequence
+
+    # @param options [::Hash]
+    # @option options [String, nil] :path (nil) The path of the log
+    #   file. Entries are appended to the file.
+    # @option options [Integer] :capacity (65536) The max number of
+    #   entries kept in memory. It's used only when `:path` isn't
+    #   specified. Old entries are overwritten.
+    # @option options [Boolean] :sync (false) Whether each entry is
+    #   written to the file immediately. If it's `false`, entries are
+    #   buffered until {#flush}.
+    def initialize(options={})
+      @path = options[:path]
+      if @path
+        @capacity = nil
+        @output = File.open(@path, "ab")
+        @output.sync = options[:sync] || false
+        @sequence = @output.size / ENTRY_SIZE
+        # A partially written entry is left by a crash. It's removed
+        # because new entries must be aligned.
+        if @output.size != @sequence * ENTRY_SIZE
+          @output.truncate(@sequence * ENTRY_SIZE)
+        end
+      else
+        @capacity = options[:capacity] || 65536
+        @entries = ::Array.new(@capacity)
+        @sequence = 0
+      end
+    end
+
+    # @private
+    #
+    # It's called by the bindings for each change. It's called for
+    # each write. So it packs the arguments directly without
+    # creating an {Entry}.
+    def record(type, table_id, record_id, column_id)
+      @sequence += 1
+      time = Process.clock_gettime(Process::CLOCK_REALTIME, :microsecond)
+      data = [@sequence, time, type, table_id, record_id, column_id].
+        pack(ENTRY_FORMAT)
+      if @output
+        @output.write(data)
+      else
+        @entries[@sequence % @capacity] = data
+      end
+      nil
+    end
+
+    # Enumerates entries kept in memory after _sequence_. Use
+    # {Groonga::ChangeLog::Reader} for a log file.
+    #
+    # @param sequence [Integer] The sequence number of the last
+    #   applied entry.
+    # @yield [entry]
+    # @yieldparam entry [Groonga::ChangeLog::Entry]
+    # @raise [Groonga::ChangeLog::BrokenLog] If entries after
+    #   _sequence_ are already overwritten by newer entries. The
+    #   consumer missed changes and needs to rescan the database.
+    def each(sequence=0)
+      return to_enum(__method__, sequence) unless block_given?
+      if @output
+        raise ArgumentError, "use Groonga::ChangeLog::Reader for a log file"
+      end
+      oldest_sequence = [@sequence - @capacity + 1, 1].max
+      if sequence + 1 < oldest_sequence
+        message = "change log entries are overwritten: " +
+          "expected sequence: <#{sequence + 1}>: " +
+          "oldest: <#{oldest_sequence}>"
+        raise BrokenLog, message
+      end
+      (sequence + 1).upto(@sequence) do |entry_sequence|
+        yield(Entry.unpack(@entries[entry_sequence % @capacity]))
+      end
+    end
+
+    # Writes buffered entries to the log file.
+    def flush
+      @output.flush if @output
+    end
+
+    # Closes the log file.
+    def close
+      return if @output.nil?
+      @output.close
+      @output = nil
+    end
+
+    # It reads a log file written by {Groonga::ChangeLog}
+    # incrementally.
+    class Reader
+      # @return [Integer] The sequence number of the last read entry.
+      #   Save it to resume reading after restart.
+      attr_reader :sequence
+
+      # @param path [String] The path of the log file.
+      # @param options [::Hash]
+      # @option options [Integer] :sequence (0) The sequence number
+      #   of the last applied entry. Reading starts from the next
+      #   entry.
+      def initialize(path, options={})
+        @path = path
+        @sequence = options[:sequence] || 0
+      end
+
+      # Reads entries appended after the last read entry. A partially
+      # written entry is read next time.
+      #
+      # @yield [entry]
+      # @yieldparam entry [Groonga::ChangeLog::Entry]
+      # @raise [Groonga::ChangeLog::BrokenLog] If an entry isn't the
+      #   next entry of the last read entry.
+      # @return [Integer] The number of read entries.
+      def each
+        return to_enum(__method__) unless block_given?
+        return 0 unless File.exist?(@path)
+        n_entries = 0
+        File.open(@path, "rb") do |input|
+          input.seek(@sequence * ENTRY_SIZE)
+          while (data = input.read(ENTRY_SIZE))
+            break if data.bytesize < ENTRY_SIZE
+            entry = Entry.unpack(data)
+            if entry.sequence != @sequence + 1
+              message = "broken change log: <#{@path}>: " +
+                "expected sequence: <#{@sequence + 1}>: " +
+                "actual: <#{entry.sequence}>"
+              raise BrokenLog, message
+            end
+            @sequence = entry.sequence
+            n_entries += 1
+            yield(entry)
+          end
+        end
+        n_entries
+      end
+
+      # Reads entries forever. It waits for new entries when all
+      # entries are read.
+      #
+      # @param options [::Hash]
+      # @option options [Numeric] :interval (1) The wait time in
+      #   seconds when there are no new entries.
+      # @yield [entry]
+      # @yieldparam entry [Groonga::ChangeLog::Entry]
+      def follow(options={}, &block)
+        interval = options[:interval] || 1
+        loop do
+          sleep(interval) if each(&block).zero?
+        end
+      end
+    end
+  end
+end
@@ -46,9 +46,17 @@ module Groonga
       #   doesn't show it otherwise. If {#show_tables?} is false, information
       #   about columns isn't always shown.
       attr_writer :show_columns
+
+      # @return [Groonga::ResidencyManager, nil] (nil) Shows mapped
+      #   size of tables and columns tracked by the manager if it's
+      #   specified.
+      #
+      # @since 12.0.9
+      attr_accessor :residency_manager
       def initialize
         @show_tables = true
         @show_columns = true
+        @residency_manager = nil
       end
 
       # (see #show_tables=)
@@ -83,14 +91,33 @@ module Groonga
           write("N records:        #{count_total_n_records}\n")
           write("N tables:         #{count_n_tables}\n")
           write("N columns:        #{count_total_n_columns}\n")
+          report_residency
           report_plugins
           report_tables
         end
       end
 
       private
-      def push_memory_pool(&block)
-        @database.context.push_memory_pool(&block)
+      def catalog
+        @catalog ||= @database.catalog
+      end
+
+      def report_residency
+        manager = @options.residency_manager
+        return if manager.nil?
+        write("Residency:\n")
+        indent do
+          write("Mapped size: #{inspect_disk_usage(manager.mapped_size)}\n")
+          budget = manager.budget
+          if budget
+            write("Budget:      #{inspect_disk_usage(budget)}\n")
+          else
+            write("Budget:      (unlimited)\n")
+          end
+          write("N objects:   #{manager.size}\n")
+          n_pinned_objects = manager.count(&:pinned?)
+          write("N pinned:    #{n_pinned_objects}\n")
+        end
       end
 
       def report_plugins
@@ -111,13 +138,13 @@ module Groonga
         return unless @options.show_tables?
         write("Tables:\n")
         indent do
-          tables = @database.tables
-          if tables.empty?
+          table_entries = catalog.tables
+          if table_entries.empty?
             write("None\n")
             return
           end
-          tables.each do |table|
-            report_table(table)
+          table_entries.each do |table_entry|
+            report_table(@context[table_entry.name])
           end
         end
       end
@@ -137,7 +164,8 @@ module Groonga
           write("Disk usage:       " +
                 "#{inspect_sub_disk_usage(table.disk_usage)}\n")
           write("N records:        #{table.size}\n")
-          write("N columns:        #{table.columns.size}\n")
+          report_mapped_size(table.name, "Mapped size:      ")
+          write("N columns:        #{catalog.columns(table.name).size}\n")
           report_columns(table)
         end
       end
@@ -146,38 +174,51 @@ module Groonga
         return unless @options.show_columns?
         write("Columns:\n")
         indent do
-          columns = table.columns
-          if columns.empty?
+          column_entries = catalog.columns(table.name)
+          if column_entries.empty?
             write("None\n")
             return
           end
-          columns.each do |column|
-            report_column(column)
+          column_entries.each do |column_entry|
+            report_column(column_entry)
           end
         end
       end
 
       def report_column(column)
+        column = catalog[column.name] if column.is_a?(Groonga::Object)
         write("#{column.local_name}:\n")
         indent do
           write("ID:         #{column.id}\n")
           write("Type:       #{inspect_column_type(column)}\n")
-          if column.index?
-            sources = column.sources
-            write("N sources:  #{sources.size}\n")
-            unless sources.empty?
+          if column.index_column?
+            source_names = inspect_source_names(column)
+            write("N sources:  #{source_names.size}\n")
+            unless source_names.empty?
               write("Sources:\n")
               indent do
-                sources.each do |source|
-                  write("Name:     #{inspect_source(source)}\n")
+                source_names.each do |source_name|
+                  write("Name:     #{source_name}\n")
                 end
               end
             end
           else
-            write("Value type: #{inspect_value_type(column.range)}\n")
+            write("Value type: #{inspect_column_value_type(column)}\n")
           end
           write("Path:       #{inspect_path(column.path)}\n")
           write("Disk usage: #{inspect_sub_disk_usage(column.disk_usage)}\n")
+          report_mapped_size(column.name, "Mapped size: ")
+        end
+      end
+
+      def report_mapped_size(object, label)
+        manager = @options.residency_manager
+        return if manager.nil?
+        mapped_size = inspect_disk_usage(manager.mapped_size(object))
+        if manager.pinned?(object)
+          write("#{label}#{mapped_size} (pinned)\n")
+        else
+          write("#{label}#{mapped_size}\n")
         end
       end
 
@@ -229,20 +270,18 @@ module Groonga
       end
 
       def count_total_n_records
-        @database.tables.inject(0) do |previous, table|
-          previous + table.size
+        catalog.tables.inject(0) do |previous, table_entry|
+          previous + @context[table_entry.name].size
         end
       end
 
       def count_n_tables
-        @database.tables.size
+        catalog.tables.size
       end
 
       def count_total_n_columns
-        @database.tables.inject(0) do |previous, table|
-          push_memory_pool do
-            previous + table.columns.size
-          end
+        catalog.tables.inject(0) do |previous, table_entry|
+          previous + catalog.columns(table_entry.name).size
         end
       end
 
@@ -251,16 +290,16 @@ module Groonga
       end
 
       def count_total_disk_usage
-        @database.tables.inject(@database.disk_usage) do |previous, table|
-          previous + count_total_table_disk_usage(table)
+        catalog.tables.inject(@database.disk_usage) do |previous, table_entry|
+          previous + count_total_table_disk_usage(table_entry)
         end
       end
 
       def count_total_table_disk_usage(table)
-        push_memory_pool do
-          table.columns.inject(table.disk_usage) do |previous, column|
-            previous + column.disk_usage
-          end
+        table_entry = catalog[table.name]
+        column_entries = catalog.columns(table.name)
+        column_entries.inject(table_entry.disk_usage) do |previous, column_entry|
+          previous + column_entry.disk_usage
         end
       end
 
@@ -321,16 +360,40 @@ module Groonga
         end
       end
 
-      def inspect_column_type(column)
-        if column.index?
+      def inspect_column_type(column_entry)
+        if column_entry.index_column?
           "index"
-        elsif column.vector?
+        elsif column_entry.vector_column?
           "vector"
         else
           "scalar"
         end
       end
 
+      def inspect_column_value_type(column_entry)
+        range_name = column_entry.range_name
+        return range_name if range_name
+        inspect_value_type(@context[column_entry.name].range)
+      end
+
+      def inspect_source_names(column_entry)
+        source_names = column_entry.source_names
+        if source_names.nil?
+          column = @context[column_entry.name]
+          return column.sources.collect do |source|
+            inspect_source(source)
+          end
+        end
+        source_names.collect do |source_name|
+          source_entry = catalog[source_name]
+          if source_entry and source_entry.table?
+            "#{source_name}._key"
+          else
+            source_name
+          end
+        end
+      end
+
       def inspect_source(source)
         if source.is_a?(Table)
           "#{source.name}._key"
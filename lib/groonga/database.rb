@@ -50,5 +50,190 @@ module Groonga
         object.dump(output_directory)
       end
     end
+
+    # The result of {Groonga::Database#preload}.
+    #
+    # @since 12.0.9
+    class PreloadReport < Struct.new(:n_objects, :n_bytes, :elapsed_time)
+      # @return [Float] The number of warmed bytes per second.
+      def bytes_per_second
+        return 0.0 if elapsed_time.zero?
+        n_bytes / elapsed_time
+      end
+    end
+
+    PRELOAD_MODES = [:open, :advise, :read]
+    PRELOAD_READ_SIZE = 1024 * 1024
+
+    # Opens objects in the database eagerly and warms their files
+    # up. It's useful just after a process is started. Groonga opens
+    # and maps objects lazily on the first access. So the first
+    # requests are slow without preloading.
+    #
+    # @example Preload all objects
+    #   report = database.preload
+    #   p report.n_bytes
+    #
+    # @example Preload hot objects by reading their files
+    #   database.preload(["Users", "Terms*"], :mode => :read)
+    #
+    # @overload preload(targets=nil, options={})
+    #   @param targets [nil, ::Array<String, Regexp, Groonga::Object>]
+    #     The objects to be preloaded. `String` is a name or a
+    #     `File.fnmatch` pattern such as `"Terms*"`. `nil` means all
+    #     objects. Columns of a matched table are also preloaded.
+    #   @param options [::Hash] The name and value
+    #     pairs. Omitted names are initialized as the default value.
+    #   @option options [:open, :advise, :read] :mode (:advise)
+    #     How to warm files up.
+    #
+    #     * `:open`: Only opens objects.
+    #     * `:advise`: Opens objects and tells the kernel that their
+    #       files will be needed by `posix_fadvise(POSIX_FADV_WILLNEED)`
+    #       via `IO#advise`. The kernel reads them ahead asynchronously.
+    #     * `:read`: Opens objects and reads their files to the end.
+    #       Pages are in the page cache when it returns.
+    #   @option options [Integer] :n_workers (4)
+    #     The number of threads that warm files up. Objects are
+    #     always opened in the current thread.
+    #   @return [Groonga::Database::PreloadReport] The number of
+    #     preloaded objects, the number of warmed bytes and the
+    #     elapsed time in seconds. The number of warmed bytes is the
+    #     read bytes for `:read`, the advised bytes for `:advise` and
+    #     `0` for `:open`.
+    #
+    # @since 12.0.9
+    def preload(targets=nil, options={})
+      if targets.is_a?(::Hash)
+        options = targets
+        targets = nil
+      end
+      mode = options[:mode] || :advise
+      unless PRELOAD_MODES.include?(mode)
+        message = "mode must be one of #{PRELOAD_MODES.inspect}: " +
+          "<#{mode.inspect}>"
+        raise ArgumentError, message
+      end
+      n_workers = options[:n_workers] || 4
+
+      start_time = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      objects = collect_preload_objects(targets)
+      paths = []
+      objects.each do |object|
+        path = object.path
+        next if path.nil?
+        paths.concat(Dir.glob("#{path}{,.*}"))
+      end
+      paths.uniq!
+      if mode == :open
+        n_bytes = 0
+      else
+        n_bytes = warm_up_paths(paths, mode, n_workers)
+      end
+      elapsed_time =
+        Process.clock_gettime(Process::CLOCK_MONOTONIC) - start_time
+      PreloadReport.new(objects.size, n_bytes, elapsed_time)
+    end
+
+    private
+    def collect_preload_objects(targets)
+      objects = {}
+      if targets.nil?
+        each(:ignore_missing_object => true, :order_by => :id) do |object|
+          objects[object.id] = object
+        end
+        return objects.values
+      end
+
+      names = []
+      patterns = []
+      targets = [targets] unless targets.is_a?(::Array)
+      targets.each do |target|
+        case target
+        when Groonga::Object
+          add_preload_object(objects, target)
+        when Regexp
+          patterns << target
+        else
+          target = target.to_s
+          if /[*?\[{]/ =~ target
+            patterns << target
+          else
+            names << target
+          end
+        end
+      end
+
+      names.each do |name|
+        object = context[name]
+        raise ArgumentError, "nonexistent object: <#{name}>" if object.nil?
+        add_preload_object(objects, object)
+      end
+      unless patterns.empty?
+        each(:ignore_missing_object => true, :order_by => :id) do |object|
+          name = object.name
+          next if name.nil?
+          matched = patterns.any? do |pattern|
+            if pattern.is_a?(Regexp)
+              pattern =~ name
+            else
+              File.fnmatch(pattern, name, File::FNM_EXTGLOB)
+            end
+          end
+          add_preload_object(objects, object) if matched
+        end
+      end
+      objects.values
+    end
+
+    def add_preload_object(objects, object)
+      objects[object.id] = object
+      return unless object.is_a?(Groonga::Table)
+      object.columns.each do |column|
+        objects[column.id] = column
+      end
+    end
+
+    def warm_up_paths(paths, mode, n_workers)
+      queue = Queue.new
+      paths.each do |path|
+        queue << path
+      end
+      workers = [n_workers, paths.size].min.times.collect do
+        Thread.new do
+          buffer = String.new
+          n_bytes = 0
+          loop do
+            begin
+              path = queue.pop(true)
+            rescue ThreadError
+              break
+            end
+            n_bytes += warm_up_path(path, mode, buffer)
+          end
+          n_bytes
+        end
+      end
+      workers.inject(0) do |n_bytes, worker|
+        n_bytes + worker.value
+      end
+    end
+
+    def warm_up_path(path, mode, buffer)
+      File.open(path, "rb") do |file|
+        case mode
+        when :advise
+          file.advise(:willneed)
+          file.size
+        when :read
+          file.advise(:sequential)
+          n_bytes = 0
+          while file.read(PRELOAD_READ_SIZE, buffer)
+            n_bytes += buffer.bytesize
+          end
+          n_bytes
+        end
+      end
+    end
   end
 end
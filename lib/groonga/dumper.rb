@@ -280,14 +280,15 @@ module Groonga
       end
 
       def each_table
-        each_options = {:order_by => :key, :ignore_missing_object => true}
+        context = @database.context
         reference_tables = []
-        @database.each(each_options) do |object|
-          next unless object.is_a?(Groonga::Table)
-          if reference_table?(object)
-            reference_tables << object
+        catalog.tables.each do |table_entry|
+          table = context[table_entry.name]
+          next if table.nil?
+          if reference_table?(table)
+            reference_tables << table
           else
-            yield(object)
+            yield(table)
           end
         end
         reference_tables.each do |table|
@@ -295,6 +296,10 @@ module Groonga
         end
       end
 
+      def catalog
+        @catalog ||= @database.catalog
+      end
+
       def each_column(table, &block)
         sorted_columns = table.columns.sort_by {|column| column.local_name}
         sorted_columns.each(&block)
@@ -759,20 +764,23 @@ module Groonga
         ""
       else
         return value unless value.respond_to?(:valid_encoding?)
-        sanitized_value = ""
         value = fix_encoding(value)
-        value.each_char do |char|
-          if char.valid_encoding?
-            sanitized_value << char
-          else
-            table_name = record.table.name
-            record_id = record.record_id
-            column_name = column.local_name
-            error_write("warning: ignore invalid encoding character: " +
-                          "<#{table_name}[#{record_id}].#{column_name}>: " +
-                          "<#{inspect_invalid_char(char)}>: " +
-                          "before: <#{sanitized_value}>\n")
-          end
+        invalid_ranges = []
+        sanitized_value = Groonga::Encoding.sanitize(value) do |offset, length|
+          invalid_ranges << [offset, length]
+        end
+        n_removed_bytes = 0
+        invalid_ranges.each do |offset, length|
+          table_name = record.table.name
+          record_id = record.record_id
+          column_name = column.local_name
+          char = value.byteslice(offset, length)
+          before = sanitized_value.byteslice(0, offset - n_removed_bytes)
+          error_write("warning: ignore invalid encoding character: " +
+                        "<#{table_name}[#{record_id}].#{column_name}>: " +
+                        "<#{inspect_invalid_char(char)}>: " +
+                        "before: <#{before}>\n")
+          n_removed_bytes += length
         end
         sanitized_value
       end
@@ -25,6 +25,7 @@ module Groonga
     attr_accessor :allow_update
     attr_accessor :allow_leading_not
     attr_accessor :default_column
+    attr_accessor :optimize
 
     VALID_COLUMN_NAME_RE = /\A[a-zA-Z\d_]+\z/
 
@@ -38,6 +39,7 @@ module Groonga
       @allow_update = nil
       @allow_leading_not = nil
       @default_column = nil
+      @optimize = nil
     end
 
     def build(&block)
@@ -86,12 +88,93 @@ module Groonga
         combined_builder = builders.inject do |previous, builder|
           previous & builder
         end
+        if @optimize
+          planner = ConditionPlanner.new(@table)
+          combined_builder, plan = planner.plan(combined_builder)
+          expression.condition_plan = plan
+        end
         combined_builder.build(expression, variable)
       end
 
       expression
     end
 
+    # @private
+    #
+    # Reorders conditions in AND by their estimated sizes. Conditions
+    # that can use indexes are evaluated first in ascending order of
+    # their estimated sizes. Other conditions are evaluated after
+    # them in the written order. They are evaluated only against
+    # records that are matched by the former conditions.
+    class ConditionPlanner
+      def initialize(table)
+        @table = table
+        @n_records = table.size
+      end
+
+      # @return [::Array<(ExpressionBuilder, Groonga::ConditionPlan)>]
+      #   The reordered builder and its plan.
+      def plan(builder)
+        case builder
+        when AndExpressionBuilder
+          plan_and(builder)
+        else
+          [builder, create_plan(builder, [])]
+        end
+      end
+
+      private
+      def plan_and(builder)
+        planned = flatten_and(builder).collect do |sub_builder|
+          plan(sub_builder)
+        end
+        ordered = planned.each_with_index.sort_by do |(_, sub_plan), i|
+          if sub_plan.indexed?
+            [0, sub_plan.estimated_size, i]
+          else
+            [1, 0, i]
+          end
+        end
+        ordered_builders = ordered.collect {|(sub_builder, _), _| sub_builder}
+        sub_plans = ordered.collect {|(_, sub_plan), _| sub_plan}
+        optimized_builder = ordered_builders.inject do |previous, sub_builder|
+          AndExpressionBuilder.new(previous, sub_builder)
+        end
+        [optimized_builder, create_plan(optimized_builder, sub_plans)]
+      end
+
+      def flatten_and(builder)
+        return [builder] unless builder.is_a?(AndExpressionBuilder)
+        builder.expression_builders.collect do |sub_builder|
+          flatten_and(sub_builder)
+        end.flatten(1)
+      end
+
+      def create_plan(builder, sub_plans)
+        estimated_size = estimate_size(builder)
+        if sub_plans.empty?
+          indexed = (estimated_size < @n_records)
+        else
+          indexed = sub_plans.any?(&:indexed?)
+        end
+        ConditionPlan.new(builder.to_condition_string,
+                          estimated_size,
+                          indexed,
+                          sub_plans)
+      end
+
+      def estimate_size(builder)
+        expression = Expression.new(:context => @table.context)
+        begin
+          variable = expression.define_variable(:domain => @table)
+          builder.build(expression, variable)
+          expression.estimate_size
+        ensure
+          expression.close
+        end
+      end
+    end
+
     # @private
     class ExpressionBuilder
       def initialize
@@ -109,16 +192,28 @@ module Groonga
       def -(other)
         AndNotExpressionBuilder.new(self, other)
       end
+
+      def to_condition_string
+        self.class.name.split("::").last
+      end
     end
 
     # @private
     class SetExpressionBuilder < ExpressionBuilder
+      attr_reader :expression_builders
       def initialize(operation, *expression_builders)
         super()
         @operation = operation
         @expression_builders = expression_builders
       end
 
+      def to_condition_string
+        sub_conditions = @expression_builders.collect do |builder|
+          builder.to_condition_string
+        end
+        "#{@operation}(#{sub_conditions.join(', ')})"
+      end
+
       def build(expression, variable)
         return if @expression_builders.empty?
         @expression_builders.each do |builder|
@@ -170,6 +265,10 @@ module Groonga
         expression.append_operation(Groonga::Operation::GET_VALUE, 2)
       end
 
+      def to_condition_string
+        @column_name.to_s
+      end
+
       def ==(other)
         EqualExpressionBuilder.new(self, normalize(other))
       end
@@ -352,6 +451,12 @@ module Groonga
         expression.append_constant(@value)
         expression.append_operation(@operation, 2)
       end
+
+      def to_condition_string
+        column = @column_value_builder.to_condition_string
+        value = @value.is_a?(Record) ? @value.record_id : @value
+        "#{@operation}(#{column}, #{value.inspect})"
+      end
     end
 
     # @private
@@ -456,6 +561,10 @@ module Groonga
       def build(expression, variable)
         expression.parse(@query, @options)
       end
+
+      def to_condition_string
+        "query(#{@query.inspect})"
+      end
     end
 
     # @private
@@ -508,6 +617,10 @@ module Groonga
         end
         expression.append_operation(Operation::CALL, @arguments.size)
       end
+
+      def to_condition_string
+        "#{@function.name}(...)"
+      end
     end
   end
 
@@ -0,0 +1,78 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  class Expression
+    # @return [Groonga::ConditionPlan, nil] The plan chosen by
+    #   {Groonga::Table#select} with `:optimize => true`. It's `nil`
+    #   when conditions aren't optimized.
+    #
+    # @since 12.0.9
+    attr_accessor :condition_plan
+  end
+
+  # The order of conditions chosen by {Groonga::Table#select} with
+  # `:optimize => true`.
+  #
+  # Each condition has its estimated number of matched records by
+  # {Groonga::Expression#estimate_size}. Children of an `and`
+  # condition are ordered as they're evaluated.
+  #
+  # @example
+  #   result = users.select(:optimize => true) do |record|
+  #     (record.age > 20) & (record.name == "mori")
+  #   end
+  #   puts(result.expression.condition_plan)
+  #   # and(equal(name, "mori"), greater(age, 20)): 1 (indexed)
+  #   #   equal(name, "mori"): 1 (indexed)
+  #   #   greater(age, 20): 100
+  #
+  # @since 12.0.9
+  class ConditionPlan
+    # @return [String] The condition.
+    attr_reader :condition
+    # @return [Integer] The estimated number of matched records.
+    attr_reader :estimated_size
+    # @return [::Array<Groonga::ConditionPlan>] The sub conditions in
+    #   evaluation order.
+    attr_reader :children
+    def initialize(condition, estimated_size, indexed, children=[])
+      @condition = condition
+      @estimated_size = estimated_size
+      @indexed = indexed
+      @children = children
+    end
+
+    # @return [Boolean] `true` if the condition can be evaluated by
+    #   indexes, `false` if it's evaluated by sequential scan.
+    def indexed?
+      @indexed
+    end
+
+    def to_s
+      lines = []
+      collect_lines(lines, 0)
+      lines.join("\n")
+    end
+
+    protected
+    def collect_lines(lines, depth)
+      line = "#{'  ' * depth}#{@condition}: #{@estimated_size}"
+      line << " (indexed)" if @indexed
+      lines << line
+      @children.each do |child|
+        child.collect_lines(lines, depth + 1)
+      end
+    end
+  end
+end
@@ -0,0 +1,139 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  class FixSizeColumn
+    # An in-process write-combining buffer for
+    # {Groonga::FixSizeColumn#increment_many!}. Deltas for the same
+    # record are merged in the buffer and they are applied by one
+    # {Groonga::FixSizeColumn#increment_many!} call on {#flush}.
+    #
+    # Buffered deltas aren't visible from the column until they are
+    # flushed. They are lost if the process exits without
+    # {#flush}.
+    #
+    # @example Merge click counts
+    #   buffer = Groonga["Entries.n_clicks"].increment_buffer
+    #   queue.each do |entry_id|
+    #     buffer.increment(entry_id)
+    #   end
+    #   buffer.flush
+    #
+    # @since 12.0.9
+    class IncrementBuffer
+      DEFAULT_MAX_ENTRIES = 10000
+
+      # @return [Groonga::FixSizeColumn] The target column.
+      attr_reader :column
+      # @return [Integer] The max number of buffered records. The
+      #   buffer is flushed automatically when it's reached.
+      attr_reader :max_entries
+      def initialize(column, options={})
+        @column = column
+        @max_entries = options[:max_entries] || DEFAULT_MAX_ENTRIES
+        @lock = options.fetch(:lock, true)
+        @timeout = options[:timeout] || 0
+        @deltas = {}
+        @mutex = Mutex.new
+      end
+
+      # Adds `delta` for the record.
+      #
+      # @param id [Integer, Groonga::Record] The record ID.
+      # @param delta [Numeric] The delta.
+      # @return [void]
+      def increment(id, delta=1)
+        id = id.id if id.is_a?(Record)
+        @mutex.synchronize do
+          @deltas[id] = (@deltas[id] || 0) + delta
+          flush_without_lock if @deltas.size >= @max_entries
+        end
+      end
+
+      # Subtracts `delta` from the record.
+      #
+      # @param id [Integer, Groonga::Record] The record ID.
+      # @param delta [Numeric] The delta.
+      # @return [void]
+      def decrement(id, delta=1)
+        increment(id, -delta)
+      end
+
+      # @return [Integer] The number of buffered records.
+      def size
+        @mutex.synchronize do
+          @deltas.size
+        end
+      end
+
+      def empty?
+        size.zero?
+      end
+
+      # Applies all buffered deltas to the column.
+      #
+      # If the column can't be locked, nothing is applied and the
+      # deltas are kept for the next flush. If applying is failed
+      # after the column is locked, some deltas may be already
+      # applied. The deltas are discarded in the case because
+      # applying them again may apply some deltas twice.
+      #
+      # @raise [Groonga::Error] If the column can't be locked or
+      #   deltas can't be applied.
+      # @return [Integer] The number of updated records.
+      def flush
+        @mutex.synchronize do
+          flush_without_lock
+        end
+      end
+
+      private
+      def flush_without_lock
+        return 0 if @deltas.empty?
+        deltas = @deltas
+        @deltas = {}
+        return apply(deltas) unless @lock
+        begin
+          @column.lock(:timeout => @timeout)
+        rescue Groonga::Error
+          @deltas.merge!(deltas) {|_, new_delta, delta| new_delta + delta}
+          raise
+        end
+        begin
+          apply(deltas)
+        ensure
+          @column.unlock
+        end
+      end
+
+      def apply(deltas)
+        @column.increment_many!(deltas.keys, deltas.values, :lock => false)
+      end
+    end
+
+    # Creates a write-combining buffer for the column.
+    #
+    # @param options [::Hash] The name and value pairs.
+    # @option options [Integer] :max_entries
+    #   (IncrementBuffer::DEFAULT_MAX_ENTRIES) The max number of
+    #   buffered records.
+    # @option options [Boolean] :lock (true) See {#increment_many!}.
+    # @option options [Integer] :timeout (0) See {#increment_many!}.
+    # @return [Groonga::FixSizeColumn::IncrementBuffer]
+    #
+    # @since 12.0.9
+    def increment_buffer(options={})
+      IncrementBuffer.new(self, options)
+    end
+  end
+end
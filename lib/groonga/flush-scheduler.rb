@@ -0,0 +1,266 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # It flushes {Groonga::Flushable} objects in a background thread.
+  #
+  # Writers request flushes of changed objects by {#request} or
+  # {#commit}. Requests for the same object are coalesced. Each
+  # flush round flushes each requested object once and then the
+  # database.
+  #
+  # The durability level is one of the followings:
+  #
+  #   * `:none`: Nothing is flushed. Changes are written by the OS.
+  #     {Groonga::Database#recover} may be needed after a crash.
+  #   * `:interval`: Requested objects are flushed every `:interval`
+  #     seconds.
+  #   * `:group_commit`: Requested objects are flushed as soon as
+  #     possible. Requests that arrive within `:max_delay` seconds
+  #     are flushed together. {#commit} waits for the flush.
+  #
+  # Flushes run in a Ruby thread. The bindings don't release the
+  # GVL, so a flush never runs at the same time as another
+  # operation on the context.
+  #
+  # @example Group commit
+  #   scheduler = Groonga::FlushScheduler.new(database,
+  #                                           :durability => :group_commit)
+  #   users.add("mori", :age => 46)
+  #   scheduler.commit(users, users.column("age"))
+  #   # Changes are on disk here.
+  #   scheduler.stop
+  #
+  # @since 12.0.9
+  class FlushScheduler
+    DURABILITIES = [:none, :interval, :group_commit]
+
+    # It's raised by {FlushScheduler#request} and
+    # {FlushScheduler#commit} when the scheduler doesn't flush
+    # requested objects anymore.
+    class Stopped < Groonga::Error
+    end
+
+    # The statistics of a scheduler. Times are in seconds.
+    class Stats < Struct.new(:n_requests,
+                             :n_flushes,
+                             :n_flushed_objects,
+                             :n_pending_objects,
+                             :total_flush_time,
+                             :max_flush_time)
+      # @return [Float] The average time of a flush round.
+      def average_flush_time
+        return 0.0 if n_flushes.zero?
+        total_flush_time / n_flushes
+      end
+    end
+
+    # @return [Symbol] The durability level.
+    attr_reader :durability
+
+    # @param database [Groonga::Database] The database of objects.
+    # @param options [::Hash]
+    # @option options [:none, :interval, :group_commit] :durability
+    #   (:interval) The durability level.
+    # @option options [Numeric] :interval (1.0) The flush interval in
+    #   seconds for `:interval`.
+    # @option options [Numeric] :max_delay (0.01) The max time in
+    #   seconds to wait for more requests for `:group_commit`.
+    def initialize(database, options={})
+      @database = database
+      @durability = options[:durability] || :interval
+      unless DURABILITIES.include?(@durability)
+        message = "durability must be one of #{DURABILITIES.inspect}: " +
+          "<#{@durability.inspect}>"
+        raise ArgumentError, message
+      end
+      @interval = options[:interval] || 1.0
+      @max_delay = options[:max_delay] || 0.01
+      @mutex = Mutex.new
+      @requested = ConditionVariable.new
+      @flushed = ConditionVariable.new
+      @pending_objects = {}
+      @n_started_rounds = 0
+      @n_completed_rounds = 0
+      @last_error = nil
+      @last_error_round = 0
+      @stats = Stats.new(0, 0, 0, 0, 0.0, 0.0)
+      @stopping = false
+      @thread = nil
+      start unless @durability == :none
+    end
+
+    # Requests to flush objects. It doesn't wait for the flush.
+    #
+    # @param objects [::Array<Groonga::Flushable>] The changed objects.
+    # @raise [Groonga::FlushScheduler::Stopped] If the scheduler is
+    #   stopped or its thread is dead.
+    # @return [void]
+    def request(*objects)
+      return if @durability == :none
+      @mutex.synchronize do
+        ensure_running
+        add_pending_objects(objects)
+      end
+      nil
+    end
+
+    # Requests to flush objects and waits for the flush. It returns
+    # immediately for `:none`.
+    #
+    # @param objects [::Array<Groonga::Flushable>] The changed objects.
+    # @raise [Groonga::FlushScheduler::Stopped] If the scheduler is
+    #   stopped or its thread is dead. The objects aren't flushed.
+    # @raise [Exception] If the flush is failed.
+    # @return [void]
+    def commit(*objects)
+      return if @durability == :none
+      @mutex.synchronize do
+        ensure_running
+        add_pending_objects(objects)
+        target_round = @n_started_rounds + 1
+        while @n_completed_rounds < target_round
+          # Pending objects are flushed before the thread is stopped
+          # by #stop. The thread is dead if it's stopped before that.
+          raise Stopped, "flush scheduler thread is dead" if @thread.nil?
+          @flushed.wait(@mutex)
+        end
+        if @last_error and @last_error_round >= target_round
+          raise @last_error
+        end
+      end
+      nil
+    end
+
+    # @return [Groonga::FlushScheduler::Stats] The current statistics.
+    def stats
+      @mutex.synchronize do
+        stats = @stats.dup
+        stats.n_pending_objects = @pending_objects.size
+        stats
+      end
+    end
+
+    # @return [Integer] The number of opened objects in the database
+    #   that have changes not flushed yet.
+    def n_dirty_objects
+      context = @database.context
+      @database.catalog.count do |entry|
+        next false unless entry.opened?
+        object = context[entry.name]
+        object and object.dirty?
+      end
+    end
+
+    # Flushes pending objects and stops the background thread.
+    #
+    # @return [void]
+    def stop
+      thread = nil
+      @mutex.synchronize do
+        return if @thread.nil?
+        @stopping = true
+        @requested.signal
+        thread = @thread
+      end
+      thread.join
+      nil
+    end
+
+    private
+    def start
+      @thread = Thread.new do
+        begin
+          run
+        ensure
+          @mutex.synchronize do
+            @thread = nil
+            @flushed.broadcast
+          end
+        end
+      end
+    end
+
+    def ensure_running
+      return if @thread and !@stopping
+      raise Stopped, "flush scheduler is stopped"
+    end
+
+    def add_pending_objects(objects)
+      objects.each do |object|
+        @stats.n_requests += 1
+        @pending_objects[object.id] = object
+      end
+      @requested.signal if @durability == :group_commit
+    end
+
+    def run
+      loop do
+        objects = @mutex.synchronize do
+          wait_round
+          return if @stopping and @pending_objects.empty?
+          @n_started_rounds += 1
+          pending_objects = @pending_objects
+          @pending_objects = {}
+          pending_objects.values
+        end
+        error = flush_objects(objects)
+        @mutex.synchronize do
+          @n_completed_rounds += 1
+          if error
+            @last_error = error
+            @last_error_round = @n_completed_rounds
+          end
+          @flushed.broadcast
+        end
+      end
+    end
+
+    def wait_round
+      return if @stopping
+      case @durability
+      when :interval
+        @requested.wait(@mutex, @interval)
+      when :group_commit
+        @requested.wait(@mutex) while @pending_objects.empty? and !@stopping
+        @requested.wait(@mutex, @max_delay) unless @stopping
+      end
+    end
+
+    def flush_objects(objects)
+      return nil if objects.empty?
+      start_time = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      n_flushed_objects = 0
+      error = nil
+      begin
+        objects.each do |object|
+          next if object.closed?
+          object.flush(:recursive => false)
+          n_flushed_objects += 1
+        end
+        @database.flush(:recursive => false)
+      rescue => error
+        # The error is reported by #commit. The thread keeps running.
+      end
+      elapsed_time =
+        Process.clock_gettime(Process::CLOCK_MONOTONIC) - start_time
+      @mutex.synchronize do
+        @stats.n_flushes += 1
+        @stats.n_flushed_objects += n_flushed_objects
+        @stats.total_flush_time += elapsed_time
+        @stats.max_flush_time = [@stats.max_flush_time, elapsed_time].max
+      end
+      error
+    end
+  end
+end
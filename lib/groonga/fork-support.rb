@@ -0,0 +1,117 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  class << self
+    # Registers a hook that is called in a child process after fork.
+    #
+    # A context can't be used in a child process because its state
+    # and locks are copied from the parent process. In a child
+    # process, the default context is replaced with a new context
+    # that opens the same database before hooks are called. Use
+    # hooks to reopen databases of your own contexts.
+    #
+    # Hooks are called automatically by `Process.fork` on Ruby 3.1
+    # or later. Call {Groonga.run_after_fork_hooks} in your server's
+    # after fork hook on older Ruby.
+    #
+    # Tables and columns in the parent process can't be used in a
+    # child process. Look them up again by {Groonga.[]} in a child
+    # process.
+    #
+    # Files warmed in the parent process by
+    # {Groonga::Database#preload} stay in the page cache. Groonga maps
+    # files as shared mappings. So mappings in child processes use
+    # the same pages without copying them.
+    #
+    # @example Preload then fork with Unicorn
+    #   # unicorn.conf.rb
+    #   preload_app true
+    #   before_fork do |server, worker|
+    #     Groonga::Database.open("db/db").preload(:mode => :read)
+    #   end
+    #   # Groonga::Context.default is reopened automatically in
+    #   # workers on Ruby 3.1 or later.
+    #
+    # @example Reopen a database of your own context
+    #   Groonga.after_fork do
+    #     $search_context = Groonga::Context.new
+    #     $search_context.open_database("db/db")
+    #   end
+    #
+    # @yield [] It's called in a child process.
+    # @return [Proc] The registered hook.
+    #
+    # @since 12.0.9
+    def after_fork(&block)
+      raise ArgumentError, "no block is given" if block.nil?
+      ForkSupport.hooks << block
+      block
+    end
+
+    # Replaces the default context with a new context that opens the
+    # same database and calls hooks registered by
+    # {Groonga.after_fork}. It must be called in a child process.
+    #
+    # @return [void]
+    #
+    # @since 12.0.9
+    def run_after_fork_hooks
+      ForkSupport.run_after_fork_hooks
+    end
+  end
+
+  # @private
+  module ForkSupport
+    @hooks = []
+    @inherited_contexts = []
+
+    class << self
+      attr_reader :hooks
+
+      def run_after_fork_hooks
+        reopen_default_context
+        @hooks.each do |hook|
+          hook.call
+        end
+      end
+
+      private
+      def reopen_default_context
+        context = Context.class_variable_get(:@@default)
+        return if context.nil?
+        return if context.closed?
+
+        database = context.database
+        path = database ? database.path : nil
+        # Don't finalize the inherited context in the child
+        # process. It may release locks held by the parent process.
+        @inherited_contexts << context
+        Context.default = nil
+        Context.default.open_database(path) if path
+      end
+    end
+
+    module ProcessFork
+      def _fork
+        pid = super
+        ForkSupport.run_after_fork_hooks if pid.zero?
+        pid
+      end
+    end
+  end
+
+  if Process.respond_to?(:_fork)
+    Process.singleton_class.prepend(ForkSupport::ProcessFork)
+  end
+end
@@ -0,0 +1,290 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "pathname"
+
+module Groonga
+  # Builds a {Groonga::PatriciaTrie} or {Groonga::DoubleArrayTrie}
+  # lexicon from many keys at once.
+  #
+  # Keys are added in sorted order into a new table. Sorted input
+  # keeps insertion into a trie local and avoids node splits against
+  # random positions, so it's much faster than adding keys in
+  # arbitrary order by {Groonga::Table::KeySupport#add}.
+  #
+  # If the lexicon already exists, the new lexicon replaces it after
+  # all keys are added. Index columns in the existing lexicon are
+  # recreated in the new lexicon and are built from their sources.
+  # The existing lexicon must not have data columns. Other tables and
+  # columns must not refer to the existing lexicon such as a table
+  # that uses it as the key type or a column that uses it as the
+  # value type.
+  #
+  # @example Build a lexicon from a word list
+  #   builder = Groonga::LexiconBuilder.new("Words",
+  #                                         :type => :patricia_trie,
+  #                                         :key_type => "ShortText",
+  #                                         :normalizer => "NormalizerAuto")
+  #   report = builder.build("words.txt")
+  #   p report.keys_per_second
+  #
+  # @since 12.0.9
+  class LexiconBuilder
+    # The result of {Groonga::LexiconBuilder#build}.
+    class Report < Struct.new(:n_keys, :n_added, :elapsed_time)
+      # @return [Float] The number of processed keys per second.
+      def keys_per_second
+        return 0.0 if elapsed_time.zero?
+        n_keys / elapsed_time
+      end
+    end
+
+    # @param name [String] The name of the lexicon.
+    # @param options [::Hash]
+    # @option options [:patricia_trie, :double_array_trie] :type
+    #   The type of the lexicon. The type of the existing lexicon is
+    #   used by default. If there is no existing lexicon,
+    #   `:patricia_trie` is used.
+    # @option options :key_type ("ShortText") The key type. The key
+    #   type of the existing lexicon is used by default.
+    # @option options :normalizer The normalizer. The normalizer of
+    #   the existing lexicon is used by default.
+    # @option options :default_tokenizer The default tokenizer. The
+    #   default tokenizer of the existing lexicon is used by default.
+    # @option options :token_filters The token filters. The token
+    #   filters of the existing lexicon are used by default.
+    # @option options [Boolean] :sorted (false) Whether the source
+    #   keys are already sorted. If it's `false`, all keys are read
+    #   and sorted in memory before they're added.
+    # @option options [Integer] :batch_size (10000) The number of keys
+    #   added by one {Groonga::Table::KeySupport#add_keys} call.
+    # @option options [Groonga::Context] :context
+    #   (Groonga::Context.default) The context.
+    def initialize(name, options={})
+      @name = name
+      @options = options
+      @context = options[:context] || Context.default
+      @sorted = options[:sorted]
+      @batch_size = options[:batch_size] || 10000
+    end
+
+    # Builds the lexicon.
+    #
+    # @param source [::Array, ::Enumerable, String, Pathname, IO]
+    #   The keys. `String` and `Pathname` are treated as a path of
+    #   a file that has one key per line.
+    # @return [Groonga::LexiconBuilder::Report]
+    def build(source)
+      old_table = @context[@name]
+      ensure_replaceable(old_table) if old_table
+      start_time = now
+      building_table = create_building_table(old_table)
+      begin
+        n_keys, n_added = add_keys(building_table, source)
+        copy_index_columns(old_table, building_table) if old_table
+      rescue Exception
+        building_table.remove unless building_table.closed?
+        raise
+      end
+      if old_table
+        replace(old_table, building_table)
+      else
+        building_table.rename(@name)
+      end
+      Report.new(n_keys, n_added, now - start_time)
+    end
+
+    private
+    def building_name
+      "#{@name}_building"
+    end
+
+    def replaced_name
+      "#{@name}_replaced"
+    end
+
+    # The old lexicon is renamed aside before the new lexicon takes
+    # its name. It's restored if the new lexicon can't be renamed. It's
+    # removed only after the new lexicon has the name. So one of them
+    # always has the name.
+    def replace(old_table, building_table)
+      old_table.rename(replaced_name)
+      begin
+        building_table.rename(@name)
+      rescue Exception
+        old_table.rename(@name)
+        raise
+      end
+      old_table.remove
+    end
+
+    def ensure_replaceable(table)
+      if @context[replaced_name]
+        raise ArgumentError,
+              "the previous replaced lexicon still exists: " +
+              "<#{replaced_name}>"
+      end
+      unless table.is_a?(PatriciaTrie) or table.is_a?(DoubleArrayTrie)
+        raise ArgumentError,
+              "lexicon must be a patricia trie or a double array trie: " +
+              "<#{@name}>: <#{table.class}>"
+      end
+      data_columns = table.columns.reject do |column|
+        column.is_a?(IndexColumn)
+      end
+      unless data_columns.empty?
+        names = data_columns.collect(&:local_name).join(", ")
+        raise ArgumentError,
+              "lexicon that has data columns can't be rebuilt: " +
+              "<#{@name}>: <#{names}>"
+      end
+      referrers = find_referrers
+      unless referrers.empty?
+        names = referrers.collect(&:name).join(", ")
+        raise ArgumentError,
+              "lexicon that other objects refer to can't be rebuilt: " +
+              "<#{@name}>: <#{names}>"
+      end
+    end
+
+    # Other objects refer to records of the lexicon by ID. The IDs
+    # aren't kept in the new lexicon and the references would follow
+    # the old lexicon while it's renamed and removed.
+    def find_referrers
+      @context.database.catalog.select do |entry|
+        next false if entry.name == @name
+        next false if entry.table_name == @name
+        entry.domain_name == @name or entry.range_name == @name
+      end
+    end
+
+    def create_building_table(old_table)
+      leftover = @context[building_name]
+      leftover.remove if leftover
+
+      table_class = resolve_table_class(old_table)
+      create_options = {
+        :name => building_name,
+        :context => @context,
+      }
+      [
+        :key_type,
+        :normalizer,
+        :default_tokenizer,
+        :token_filters,
+      ].each do |key|
+        if @options.key?(key)
+          value = @options[key]
+        elsif old_table
+          value = inherited_option(old_table, key)
+        else
+          value = nil
+        end
+        create_options[key] = value unless value.nil?
+      end
+      create_options[:key_type] ||= "ShortText"
+      table_class.create(create_options)
+    end
+
+    def resolve_table_class(old_table)
+      case @options[:type]
+      when :patricia_trie, "patricia_trie"
+        PatriciaTrie
+      when :double_array_trie, "double_array_trie"
+        DoubleArrayTrie
+      when nil
+        old_table ? old_table.class : PatriciaTrie
+      else
+        raise ArgumentError,
+              "type must be :patricia_trie or :double_array_trie: " +
+              "<#{@options[:type].inspect}>"
+      end
+    end
+
+    def inherited_option(table, key)
+      case key
+      when :key_type
+        table.domain
+      when :normalizer
+        table.normalizer
+      when :default_tokenizer
+        table.default_tokenizer
+      when :token_filters
+        token_filters = table.token_filters
+        token_filters.empty? ? nil : token_filters
+      end
+    end
+
+    def add_keys(table, source)
+      n_keys = 0
+      n_added = 0
+      add_batch = lambda do |keys|
+        n_keys += keys.size
+        n_added += table.add_keys(keys)
+      end
+      if @sorted
+        each_key(source).each_slice(@batch_size, &add_batch)
+      else
+        keys = each_key(source).to_a
+        keys.sort!
+        keys.each_slice(@batch_size, &add_batch)
+      end
+      [n_keys, n_added]
+    end
+
+    def each_key(source, &block)
+      return to_enum(__method__, source) unless block_given?
+
+      case source
+      when String, Pathname
+        File.open(source.to_s, "r:utf-8") do |input|
+          each_line_key(input, &block)
+        end
+      when IO
+        each_line_key(source, &block)
+      else
+        source.each(&block)
+      end
+    end
+
+    def each_line_key(input)
+      input.each_line do |line|
+        key = line.chomp
+        yield(key) unless key.empty?
+      end
+    end
+
+    def copy_index_columns(old_table, new_table)
+      old_table.columns.each do |column|
+        options = {
+          :with_section => column.with_section?,
+          :with_weight => column.with_weight?,
+          :with_position => column.with_position?,
+          :sources => column.sources,
+        }
+        if column.small?
+          options[:size] = :small
+        elsif column.medium?
+          options[:size] = :medium
+        end
+        new_table.define_index_column(column.local_name,
+                                      column.range,
+                                      options)
+      end
+    end
+
+    def now
+      Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    end
+  end
+end
@@ -111,6 +111,33 @@ module Groonga
     # @option options [Integer] :page (1)
     #
     #   ページ番号。ページ番号は0ベースではなく1ベースであることに注意。
+    # @option options [::Array] :after (nil)
+    #
+    #   The sort key values of the last record in the previous page.
+    #   Use {Pagination#next_cursor} or
+    #   {CursorPagination#next_cursor} to get it. If it's
+    #   specified, records after the values are returned and
+    #   `:page` is ignored. The returned table is extended by
+    #   {CursorPagination} instead of {Pagination}.
+    #
+    #   It's "search after" pagination. Deep pages are as cheap as
+    #   the first page because they don't sort and skip all records
+    #   before the page.
+    #
+    #   _sort_keys_ should end with a unique key such as `"_id"`.
+    #   Otherwise records that have the same sort key values as the
+    #   last record in the previous page are skipped.
+    #
+    #   @since 12.0.9
+    #
+    # @example Search after pagination
+    #   sort_keys = [["_score", :desc], ["_id", :asc]]
+    #   page = entries.paginate(sort_keys, :size => 10)
+    #   while page.next_cursor
+    #     page = entries.paginate(sort_keys,
+    #                             :size => 10,
+    #                             :after => page.next_cursor)
+    #   end
     def paginate(sort_keys, options={})
       _size = size
       page_size = options[:size] || 10
@@ -119,6 +146,11 @@ module Groonga
         raise TooSmallPageSize.new(page_size, minimum_size.._size)
       end
 
+      cursor = options[:after]
+      if cursor
+        return paginate_after(sort_keys, cursor, page_size, _size)
+      end
+
       max_page = [(_size / page_size.to_f).ceil, 1].max
       page = options[:page] || 1
       if page < 1
@@ -132,8 +164,116 @@ module Groonga
       records = sort(sort_keys, :offset => offset, :limit => limit)
       records.extend(Pagination)
       records.send(:set_pagination_info, page, page_size, _size)
+      records.send(:set_sort_keys, normalize_pagination_sort_keys(sort_keys))
+      records
+    end
+
+    private
+    def paginate_after(sort_keys, cursor, page_size, n_records)
+      keys = normalize_pagination_sort_keys(sort_keys)
+      if keys.size != cursor.size
+        raise ArgumentError,
+              "the number of cursor values must be the same as " +
+              "the number of sort keys: " +
+              "<#{cursor.inspect}>: <#{sort_keys.inspect}>"
+      end
+
+      matched_records = select do |record|
+        conditions = keys.each_with_index.collect do |(name, order), i|
+          column = record[name]
+          if order == :desc
+            condition = column < cursor[i]
+          else
+            condition = column > cursor[i]
+          end
+          i.times do |j|
+            condition = (record[keys[j][0]] == cursor[j]) & condition
+          end
+          condition
+        end
+        conditions.inject do |previous, condition|
+          previous | condition
+        end
+      end
+
+      begin
+        matched_sort_keys = keys.collect do |name, order|
+          ["_key.#{name}", order]
+        end
+        sorted_records = matched_records.sort(matched_sort_keys,
+                                              :limit => page_size + 1)
+        begin
+          records = Groonga::Array.create(:value_type => self,
+                                          :context => context)
+          sorted_records.each_with_index do |sorted_record, i|
+            break if i == page_size
+            records.add.value = sorted_record.value.key
+          end
+          have_next_page = (sorted_records.size > page_size)
+        ensure
+          sorted_records.close
+        end
+      ensure
+        matched_records.close
+      end
+      records.extend(CursorPagination)
+      records.send(:set_pagination_info,
+                   page_size,
+                   n_records,
+                   cursor,
+                   have_next_page)
+      records.send(:set_sort_keys, keys)
       records
     end
+
+    def normalize_pagination_sort_keys(sort_keys)
+      sort_keys.collect do |sort_key|
+        case sort_key
+        when ::Hash
+          name = sort_key[:key]
+          order = sort_key[:order]
+        when ::Array
+          name, order = sort_key
+        else
+          name = sort_key
+          order = nil
+        end
+        name = name.local_name if name.respond_to?(:local_name)
+        case order
+        when :desc, :descending, "desc", "descending"
+          order = :desc
+        else
+          order = :asc
+        end
+        [name.to_s, order]
+      end
+    end
+  end
+
+  # @private
+  module PaginationCursorSupport
+    # @return [::Array, nil] The sort key values of the last record
+    #   in the page. Pass it to {Table#paginate} as `:after` to get
+    #   the next page. It's `nil` when there is no next page.
+    #
+    # @since 12.0.9
+    def next_cursor
+      return nil unless have_next_page?
+      last_record = nil
+      each do |record|
+        last_record = record
+      end
+      return nil if last_record.nil?
+      original_record = last_record.value
+      @sort_keys.collect do |name, _|
+        original_record[name]
+      end
+    end
+
+    private
+    def set_sort_keys(sort_keys)
+      @sort_keys = sort_keys
+    end
   end
 
   # ページネーション機能を追加するモジュール。
@@ -141,6 +281,8 @@ module Groonga
   # ページ番号やレコードが何番目かは0ベースではなく1ベースで
   # あることに注意すること。
   module Pagination
+    include PaginationCursorSupport
+
     # 現在のページ番号。
     attr_reader :current_page
     # 1ページあたりのレコード数。
@@ -240,4 +382,42 @@ module Groonga
       @n_pages = [(@n_records / @page_size.to_f).ceil, 1].max
     end
   end
+
+  # A module to add "search after" pagination features. A table
+  # returned by {Table#paginate} with `:after` is extended by this
+  # module.
+  #
+  # It doesn't have page numbers because a page is specified by the
+  # last record in the previous page instead of its offset.
+  #
+  # @since 12.0.9
+  module CursorPagination
+    include PaginationCursorSupport
+
+    # @return [Integer] The max number of records in a page.
+    attr_reader :page_size
+    # @return [Integer] The number of all records.
+    attr_reader :n_records
+    # @return [::Array] The cursor used to get this page.
+    attr_reader :cursor
+
+    # @return [Boolean] `true` if there are more records after this
+    #   page.
+    def have_next_page?
+      @have_next_page
+    end
+
+    # @return [Integer] The number of records in this page.
+    def n_records_in_page
+      size
+    end
+
+    private
+    def set_pagination_info(page_size, n_records, cursor, have_next_page)
+      @page_size = page_size
+      @n_records = n_records
+      @cursor = cursor
+      @have_next_page = have_next_page
+    end
+  end
 end
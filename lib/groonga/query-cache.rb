@@ -0,0 +1,379 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # An opt-in cache for {Groonga::Table#select} and
+  # {Groonga::Table#sort} results.
+  #
+  # A cache entry is keyed on the query signature: the query string
+  # or the expression built by the block, the select options, the
+  # normalized sort keys and offset/limit. An entry only stores the
+  # matched record IDs and scores as packed strings, not the result
+  # tables themselves.
+  #
+  # An entry is expired when {Groonga::Object#last_modified} of the
+  # source table or one of its columns is changed after the entry is
+  # created. Note that {Groonga::Object#last_modified} is meaningful
+  # only for persistent tables and columns and it has second
+  # resolution. An entry created in the same second as the last
+  # change is treated as expired.
+  #
+  # @example Cache a select and sort result
+  #   cache = Groonga::QueryCache.new(:max_bytes => 64 * 1024 * 1024)
+  #   result = cache.select(users,
+  #                         :sort_keys => [["age", :desc]],
+  #                         :limit => 10) do |record|
+  #     record.hobby == "programming"
+  #   end
+  #   result.each_with_score do |user, score|
+  #     p [user.key, score]
+  #   end
+  #   p cache.statistics.hit_rate
+  #
+  # @since 12.0.9
+  class QueryCache
+    DEFAULT_MAX_BYTES = 32 * 1024 * 1024
+
+    # Approximate bookkeeping cost of an entry in bytes.
+    ENTRY_OVERHEAD_BYTES = 128
+
+    ID_PACK_FORMAT = "L*"
+    SCORE_PACK_FORMAT = "d*"
+
+    SELECT_OPTION_NAMES = [
+      :operator,
+      :name,
+      :syntax,
+      :allow_pragma,
+      :allow_column,
+      :allow_update,
+      :allow_leading_not,
+      :default_column,
+    ]
+
+    class Statistics < Struct.new(:n_hits,
+                                  :n_misses,
+                                  :n_expired,
+                                  :n_evicted,
+                                  :n_entries,
+                                  :bytes,
+                                  :max_bytes)
+      # @return [Float] The ratio of cache hits to lookups. It's
+      #   `0.0` when the cache isn't looked up yet.
+      def hit_rate
+        n_lookups = n_hits + n_misses
+        return 0.0 if n_lookups.zero?
+        n_hits / n_lookups.to_f
+      end
+    end
+
+    # A cached select result. It has the matched record IDs and
+    # scores of the source table in sorted order.
+    class Result
+      include Enumerable
+
+      # @return [Groonga::Table] The source table.
+      attr_reader :table
+      # @return [Integer] The number of matched records before
+      #   `:offset` and `:limit` are applied.
+      attr_reader :n_hits
+      def initialize(table, packed_ids, packed_scores, n_hits)
+        @table = table
+        @packed_ids = packed_ids
+        @packed_scores = packed_scores
+        @n_hits = n_hits
+      end
+
+      # @return [Integer] The number of records in the result.
+      def size
+        @packed_ids.bytesize / 4
+      end
+
+      def empty?
+        size.zero?
+      end
+
+      # @return [::Array<Integer>] The matched record IDs.
+      def ids
+        @packed_ids.unpack(ID_PACK_FORMAT)
+      end
+
+      # @return [::Array<Float>] The scores of the matched records.
+      def scores
+        @packed_scores.unpack(SCORE_PACK_FORMAT)
+      end
+
+      # @yieldparam record [Groonga::Record] The matched record in
+      #   the source table.
+      def each
+        return to_enum(__method__) unless block_given?
+        ids.each do |id|
+          yield(Record.new(@table, id))
+        end
+      end
+
+      # @yieldparam record [Groonga::Record] The matched record in
+      #   the source table.
+      # @yieldparam score [Float] The score of the record.
+      def each_with_score
+        return to_enum(__method__) unless block_given?
+        ids.zip(scores) do |id, score|
+          yield(Record.new(@table, id), score)
+        end
+      end
+
+      # @private
+      def bytes
+        @packed_ids.bytesize + @packed_scores.bytesize
+      end
+    end
+
+    # @private
+    class Entry
+      attr_reader :result
+      attr_reader :bytes
+      def initialize(result, dependencies, created_at, key_bytes)
+        @result = result
+        @dependencies = dependencies
+        @created_at = created_at
+        @bytes = result.bytes + key_bytes + ENTRY_OVERHEAD_BYTES
+      end
+
+      def expired?
+        @dependencies.any? do |dependency|
+          dependency.closed? or
+            dependency.last_modified.to_i >= @created_at
+        end
+      end
+    end
+
+    # @return [Integer] The max total size of cached entries in bytes.
+    attr_reader :max_bytes
+
+    # @param options [::Hash] The name and value pairs.
+    # @option options [Integer] :max_bytes (DEFAULT_MAX_BYTES)
+    #   The max total size of cached entries in bytes. The least
+    #   recently used entries are evicted when it's exceeded.
+    def initialize(options={})
+      @max_bytes = options[:max_bytes] || DEFAULT_MAX_BYTES
+      @entries = {}
+      @bytes = 0
+      @n_hits = 0
+      @n_misses = 0
+      @n_expired = 0
+      @n_evicted = 0
+      @mutex = Mutex.new
+    end
+
+    # Selects records from `table` and sorts them. The result is
+    # returned from the cache if the same query is cached and the
+    # cached entry isn't expired.
+    #
+    # @overload select(table, query=nil, options={}, &block)
+    #   @param table [Groonga::Table] The source table.
+    #   @param query [String, nil] The query string. See
+    #     {Groonga::Table#select}.
+    #   @param options [::Hash] The options for
+    #     {Groonga::Table#select} and the following options.
+    #   @option options [::Array] :sort_keys The sort keys. See
+    #     {Groonga::Table#sort}. The records are ordered by record
+    #     ID when it's omitted.
+    #   @option options [Integer] :offset (0) The offset for the
+    #     sorted records.
+    #   @option options [Integer] :limit (-1) The max number of
+    #     records. `-1` means all records.
+    #   @option options [::Array<Groonga::Object>] :dependencies
+    #     The additional objects that expire the cached entry when
+    #     they are changed. The source table and its columns are
+    #     always used. You need to specify columns in other tables
+    #     that are referred by the query such as `author.name`.
+    #   @yield [record] See {Groonga::Table#select}.
+    #   @return [Groonga::QueryCache::Result]
+    def select(table, *args, &block)
+      options = args.last.is_a?(::Hash) ? args.pop : {}
+      query = args.shift
+      unless args.empty?
+        message = "wrong number of arguments: " +
+          "should be (table, query=nil, options={}): " +
+          "#{([table, query] + args).inspect}"
+        raise ArgumentError, message
+      end
+      if options[:result]
+        raise ArgumentError, ":result option isn't supported: #{options.inspect}"
+      end
+
+      expression = nil
+      if block
+        builder = RecordExpressionBuilder.new(table, options[:name])
+        builder.query = query
+        builder.syntax = options[:syntax]
+        builder.allow_pragma = options[:allow_pragma]
+        builder.allow_column = options[:allow_column]
+        builder.allow_update = options[:allow_update]
+        builder.allow_leading_not = options[:allow_leading_not]
+        builder.default_column = options[:default_column]
+        expression = builder.build(&block)
+        condition = expression.inspect
+      else
+        condition = query
+      end
+
+      key = [
+        table.id,
+        condition,
+        SELECT_OPTION_NAMES.collect {|name| options[name]},
+        normalize_sort_keys(options[:sort_keys]),
+        options[:offset] || 0,
+        options[:limit] || -1,
+      ]
+      result = lookup(key)
+      if result
+        expression.close if expression
+        return result
+      end
+
+      result = execute(table, expression || query, options)
+      dependencies = [table] + table.columns + (options[:dependencies] || [])
+      store(key, Entry.new(result, dependencies, Time.now.to_i,
+                           condition.to_s.bytesize))
+      result
+    end
+
+    # Removes all cached entries. Statistics aren't reset.
+    #
+    # @return [void]
+    def clear
+      @mutex.synchronize do
+        @entries.clear
+        @bytes = 0
+      end
+    end
+
+    # @return [Groonga::QueryCache::Statistics] The current statistics.
+    def statistics
+      @mutex.synchronize do
+        Statistics.new(@n_hits,
+                       @n_misses,
+                       @n_expired,
+                       @n_evicted,
+                       @entries.size,
+                       @bytes,
+                       @max_bytes)
+      end
+    end
+
+    # @return [Integer] The number of cached entries.
+    def size
+      @mutex.synchronize do
+        @entries.size
+      end
+    end
+
+    private
+    def normalize_sort_keys(sort_keys)
+      return nil if sort_keys.nil?
+      sort_keys.collect do |sort_key|
+        case sort_key
+        when ::Hash
+          key = sort_key[:key] || sort_key["key"]
+          order = sort_key[:order] || sort_key["order"]
+        when ::Array
+          key, order = sort_key
+        else
+          key = sort_key
+          order = nil
+        end
+        key = key.name if key.is_a?(Groonga::Object)
+        case order.to_s
+        when "desc", "descending"
+          order = :descending
+        else
+          order = :ascending
+        end
+        [key.to_s, order]
+      end
+    end
+
+    def lookup(key)
+      @mutex.synchronize do
+        entry = @entries.delete(key)
+        if entry.nil?
+          @n_misses += 1
+          return nil
+        end
+        if entry.expired?
+          @bytes -= entry.bytes
+          @n_expired += 1
+          @n_misses += 1
+          return nil
+        end
+        @entries[key] = entry
+        @n_hits += 1
+        entry.result
+      end
+    end
+
+    def store(key, entry)
+      return if entry.bytes > @max_bytes
+      @mutex.synchronize do
+        old_entry = @entries.delete(key)
+        @bytes -= old_entry.bytes if old_entry
+        @entries[key] = entry
+        @bytes += entry.bytes
+        while @bytes > @max_bytes
+          _, evicted_entry = @entries.shift
+          @bytes -= evicted_entry.bytes
+          @n_evicted += 1
+        end
+      end
+    end
+
+    def execute(table, condition, options)
+      select_options = {}
+      SELECT_OPTION_NAMES.each do |name|
+        select_options[name] = options[name] if options.key?(name)
+      end
+      if condition
+        matched = table.select(condition, select_options)
+      else
+        matched = table.select(select_options)
+      end
+      begin
+        sort_keys = options[:sort_keys]
+        offset = options[:offset] || 0
+        limit = options[:limit] || -1
+        if sort_keys
+          sorted = matched.sort(sort_keys, :offset => offset, :limit => limit)
+          begin
+            records = sorted.collect(&:value)
+          ensure
+            sorted.close
+          end
+        else
+          records = matched.to_a
+          records = records[offset..-1] || []
+          records = records[0, limit] if limit >= 0
+        end
+        ids = records.collect {|record| record.key.id}
+        scores = records.collect {|record| record.score.to_f}
+        Result.new(table,
+                   ids.pack(ID_PACK_FORMAT),
+                   scores.pack(SCORE_PACK_FORMAT),
+                   matched.size)
+      ensure
+        matched.close
+        condition.close if condition.is_a?(Expression)
+      end
+    end
+  end
+end
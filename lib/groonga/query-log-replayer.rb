@@ -0,0 +1,419 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "shellwords"
+require "thread"
+require "time"
+require "uri"
+
+require "groonga/grntest-log"
+
+module Groonga
+  # Replays commands in a Groonga query log or a grntest log against
+  # a local database and reports throughput and latency.
+  #
+  # Commands are replayed by workers. Each worker has its own
+  # {Groonga::Context}. Workers are threads or forked processes.
+  # Use processes to replay commands in parallel because a command
+  # is executed with the GVL held.
+  #
+  # @example Replay a query log with 4 processes
+  #   requests = File.open("query.log") do |log|
+  #     Groonga::QueryLogReplayer::Parser.new.parse(log)
+  #   end
+  #   replayer = Groonga::QueryLogReplayer.new("db/db",
+  #                                            :n_workers => 4,
+  #                                            :mode => :process)
+  #   report = replayer.replay(requests)
+  #   report.print($stdout)
+  #
+  # @since 12.0.9
+  class QueryLogReplayer
+    # A command to be replayed.
+    #
+    # `relative_time` is the time in seconds since the first command
+    # in the log. `original_elapsed_time` is the elapsed time in
+    # seconds recorded in the log. It's `nil` if it isn't recorded.
+    class Request < Struct.new(:command,
+                               :relative_time,
+                               :original_elapsed_time)
+    end
+
+    # A result of a replayed command. `error` is a message of the
+    # raised error or `nil`.
+    class Response < Struct.new(:request, :elapsed_time, :error)
+      def success?
+        error.nil?
+      end
+    end
+
+    # Parses a Groonga query log or a grntest log. The format is
+    # detected by the first line.
+    class Parser
+      QUERY_LOG_ENTRY =
+        /\A(\d{4}-\d\d-\d\d \d\d:\d\d:\d\d\.\d+)\|([^|]+)\|([<>])(.*)\z/
+
+      # @param input [#gets, #each_line] The log.
+      # @return [::Array<Groonga::QueryLogReplayer::Request>] The
+      #   commands in the log ordered by the start time.
+      def parse(input)
+        first_line = input.gets
+        return [] if first_line.nil?
+        input = PrependedInput.new(first_line, input)
+        if first_line.start_with?("[")
+          requests = parse_grntest_log(input)
+        else
+          requests = parse_query_log(input)
+        end
+        requests.sort_by(&:relative_time)
+      end
+
+      private
+      def parse_grntest_log(input)
+        requests = []
+        GrntestLog::Parser.new.parse(input) do |event|
+          next unless event.is_a?(GrntestLog::TaskEvent)
+          requests << Request.new(event.command,
+                                  event.relative_start_time / 1_000_000.0,
+                                  event.elapsed_time / 1_000_000.0)
+        end
+        requests
+      end
+
+      def parse_query_log(input)
+        requests = []
+        running_requests = {}
+        first_time = nil
+        input.each_line do |line|
+          next unless QUERY_LOG_ENTRY =~ line.chomp
+          time_stamp = $1
+          context_id = $2
+          mark = $3
+          message = $4
+          case mark
+          when ">"
+            time = Time.parse(time_stamp)
+            first_time ||= time
+            request = Request.new(message, time - first_time, nil)
+            running_requests[context_id] = request
+            requests << request
+          when "<"
+            request = running_requests.delete(context_id)
+            next if request.nil?
+            if /\A(\d+)/ =~ message
+              request.original_elapsed_time = Integer($1, 10) / 1_000_000_000.0
+            end
+          end
+        end
+        requests
+      end
+
+      # @private
+      class PrependedInput
+        def initialize(first_line, input)
+          @first_line = first_line
+          @input = input
+        end
+
+        def each_line(&block)
+          yield(@first_line)
+          @input.each_line(&block)
+        end
+      end
+    end
+
+    # Throughput and latency of a replay.
+    class Report
+      PERCENTILES = [0.5, 0.9, 0.99, 0.999]
+
+      # @return [::Array<Groonga::QueryLogReplayer::Response>]
+      attr_reader :responses
+      # @return [Float] The wall clock time of the replay in seconds.
+      attr_reader :elapsed_time
+      def initialize(responses, elapsed_time)
+        @responses = responses
+        @elapsed_time = elapsed_time
+        @sorted_elapsed_times = responses.collect(&:elapsed_time).sort
+      end
+
+      def n_requests
+        @responses.size
+      end
+
+      def n_errors
+        @responses.count {|response| not response.success?}
+      end
+
+      # @return [Float] The number of replayed commands per second.
+      def throughput
+        return 0.0 if @elapsed_time.zero?
+        n_requests / @elapsed_time
+      end
+
+      # @param rate [Float] The rate such as `0.99`.
+      # @return [Float] The latency in seconds.
+      def percentile(rate)
+        return 0.0 if @sorted_elapsed_times.empty?
+        index = (@sorted_elapsed_times.size * rate).ceil - 1
+        index = 0 if index < 0
+        @sorted_elapsed_times[index]
+      end
+
+      # @return [::Array<Groonga::QueryLogReplayer::Response>] The
+      #   `n` slowest responses in descending order.
+      def slowest(n)
+        @responses.sort_by {|response| -response.elapsed_time}.first(n)
+      end
+
+      # Prints the report.
+      #
+      # @param output [#puts]
+      # @param options [::Hash]
+      # @option options [Integer] :n_slowest (10) The number of
+      #   slowest commands to be shown.
+      # @option options [#call] :plan_dumper The object to dump the
+      #   execution plan of a command. It's called with a command
+      #   string and it returns the plan or `nil`.
+      def print(output, options={})
+        n_slowest = options[:n_slowest] || 10
+        plan_dumper = options[:plan_dumper]
+        output.puts("requests:   #{n_requests}")
+        output.puts("errors:     #{n_errors}")
+        output.puts("elapsed:    %.3fs" % @elapsed_time)
+        output.puts("throughput: %.3f requests/s" % throughput)
+        PERCENTILES.each do |rate|
+          label = "p%s:" % (rate * 100).to_s.sub(/\.0\z/, "")
+          output.puts("%-11s %.3fms" % [label, percentile(rate) * 1000])
+        end
+        return if n_slowest.zero?
+        output.puts
+        output.puts("slowest:")
+        slowest(n_slowest).each_with_index do |response, i|
+          request = response.request
+          output.puts("%d. %.3fms: %s" % [
+                        i + 1,
+                        response.elapsed_time * 1000,
+                        request.command,
+                      ])
+          if request.original_elapsed_time
+            output.puts("   original: %.3fms" %
+                          (request.original_elapsed_time * 1000))
+          end
+          output.puts("   error: #{response.error}") if response.error
+          plan = plan_dumper.call(request.command) if plan_dumper
+          next if plan.nil?
+          plan.each_line do |line|
+            output.puts("   #{line.chomp}")
+          end
+        end
+      end
+    end
+
+    # @param database_path [String] The path of the database to be
+    #   used.
+    # @param options [::Hash]
+    # @option options [Integer] :n_workers (1) The number of workers.
+    # @option options [:thread, :process] :mode (:thread)
+    #   The worker type.
+    # @option options [Boolean] :preserve_timing (false)
+    #   If it's `true`, each command is sent at its original time
+    #   relative to the first command. Otherwise commands are sent
+    #   as fast as possible.
+    # @option options [Float] :speed (1.0) The speed factor used
+    #   with `:preserve_timing`. `2.0` replays twice as fast as the
+    #   original.
+    def initialize(database_path, options={})
+      @database_path = database_path
+      @n_workers = options[:n_workers] || 1
+      @mode = options[:mode] || :thread
+      @preserve_timing = options[:preserve_timing]
+      @speed = options[:speed] || 1.0
+      unless [:thread, :process].include?(@mode)
+        raise ArgumentError,
+              "mode must be :thread or :process: <#{@mode.inspect}>"
+      end
+    end
+
+    # @param requests [::Array<Groonga::QueryLogReplayer::Request>]
+    #   The requests ordered by `relative_time`.
+    # @return [Groonga::QueryLogReplayer::Report]
+    def replay(requests)
+      start_time = now
+      case @mode
+      when :thread
+        responses = replay_by_threads(requests, start_time)
+      when :process
+        responses = replay_by_processes(requests, start_time)
+      end
+      Report.new(responses, now - start_time)
+    end
+
+    # Dumps the execution plan of the condition in a `select`
+    # command. It's useful for the slowest commands.
+    #
+    # @param command [String] The `select` command in command line
+    #   format or URI format.
+    # @param context [Groonga::Context] The context that opens the
+    #   database.
+    # @return [String, nil] The plan, or `nil` if `command` isn't a
+    #   `select` command that has a condition.
+    def dump_plan(command, context)
+      parameters = parse_select_command(command)
+      return nil if parameters.nil?
+      table = context[parameters[:table]]
+      return nil unless table.is_a?(Table)
+      query = parameters[:query]
+      filter = parameters[:filter]
+      return nil if query.nil? and filter.nil?
+
+      expression = Expression.new(:context => context)
+      begin
+        expression.define_variable(:domain => table)
+        if query
+          default_column = parameters[:match_columns]
+          expression.parse(query,
+                           :syntax => :query,
+                           :default_column => default_column)
+        end
+        if filter
+          expression.parse(filter, :syntax => :script)
+          expression.append_operation(Operation::AND, 2) if query
+        end
+        expression.dump_plan
+      rescue Error => error
+        "#{error.class}: #{error.message}"
+      ensure
+        expression.close
+      end
+    end
+
+    SELECT_PARAMETER_ORDER = [
+      :table,
+      :match_columns,
+      :query,
+      :filter,
+    ]
+
+    private
+    def parse_select_command(command)
+      parameters = {}
+      case command
+      when /\A\/d\/select(?:\.\w+)?(?:\?(.*))?\z/
+        URI.decode_www_form($1 || "").each do |name, value|
+          parameters[name.to_sym] = value
+        end
+      when /\Aselect(?:\s|\z)/
+        tokens = Shellwords.split(command)
+        tokens.shift
+        index = 0
+        until tokens.empty?
+          token = tokens.shift
+          if token.start_with?("--")
+            parameters[token[2..-1].to_sym] = tokens.shift
+          else
+            name = SELECT_PARAMETER_ORDER[index]
+            parameters[name] = token if name
+            index += 1
+          end
+        end
+      else
+        return nil
+      end
+      parameters
+    rescue ArgumentError
+      nil
+    end
+
+    def now
+      Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    end
+
+    def replay_by_threads(requests, start_time)
+      queue = Queue.new
+      requests.each do |request|
+        queue << request
+      end
+      threads = @n_workers.times.collect do
+        Thread.new do
+          responses = []
+          run_worker do |context|
+            loop do
+              begin
+                request = queue.pop(true)
+              rescue ThreadError
+                break
+              end
+              responses << execute(context, request, start_time)
+            end
+          end
+          responses
+        end
+      end
+      threads.collect(&:value).flatten(1)
+    end
+
+    def replay_by_processes(requests, start_time)
+      workers = @n_workers.times.collect do |i|
+        assigned_requests = []
+        requests.each_with_index do |request, j|
+          assigned_requests << request if j % @n_workers == i
+        end
+        input, output = IO.pipe
+        pid = fork do
+          input.close
+          responses = []
+          run_worker do |context|
+            assigned_requests.each do |request|
+              responses << execute(context, request, start_time)
+            end
+          end
+          output.write(Marshal.dump(responses))
+          output.close
+          exit!(true)
+        end
+        output.close
+        [pid, input]
+      end
+      workers.collect do |pid, input|
+        responses = Marshal.load(input.read)
+        input.close
+        Process.waitpid(pid)
+        responses
+      end.flatten(1)
+    end
+
+    def run_worker
+      Context.open do |context|
+        context.open_database(@database_path) do
+          yield(context)
+        end
+      end
+    end
+
+    def execute(context, request, start_time)
+      if @preserve_timing
+        wait_time = start_time + request.relative_time / @speed - now
+        sleep(wait_time) if wait_time > 0
+      end
+      error = nil
+      request_start_time = now
+      begin
+        context.send(request.command)
+        context.receive
+      rescue Error => error
+        error = "#{error.class}: #{error.message}"
+      end
+      Response.new(request, now - request_start_time, error)
+    end
+  end
+end
@@ -413,6 +413,15 @@ module Groonga
       @added = added
     end
 
+    # @private
+    #
+    # It's used to reuse the record in flyweight iteration.
+    def reset_id(id)
+      @id = id
+      @key = nil
+      @added = false
+    end
+
     # @private
     def inspect
       if @table.closed?
@@ -0,0 +1,276 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # It keeps the size of mapped tables and columns in a database
+  # under a budget.
+  #
+  # Groonga maps files of a table or a column when it's opened and
+  # keeps them mapped until the database is closed or
+  # {Groonga::Database#unmap} is called. The manager tracks objects
+  # opened through it in least recently used order. The budget
+  # covers all opened tables and columns in the database including
+  # objects opened by `select`, `Context#[]` and so on. They are
+  # listed by {Groonga::SchemaCatalog} and treated as less recently
+  # used than objects opened through the manager. If the total
+  # mapped size exceeds the budget, the manager closes least
+  # recently used objects until the total fits in the budget. Closed
+  # objects are mapped again on the next access.
+  #
+  # Pinned objects are never unmapped by the manager. Objects that
+  # other opened objects refer to such as a table that has opened
+  # columns or a table used as the value type of an opened column
+  # aren't unmapped either. Objects that temporary objects such as
+  # result tables refer to aren't unmapped too. Columns are unmapped
+  # before their table.
+  #
+  # Objects unmapped by the manager are closed. Don't keep them in
+  # your code. Use {#[]} for each access instead.
+  #
+  # @example Keep mapped files under 1GiB
+  #   manager = Groonga::ResidencyManager.new(database,
+  #                                           :budget => 1024 ** 3)
+  #   manager.pin("Terms.index")
+  #   users = manager["Users"]
+  #   p manager.mapped_size
+  #
+  # @since 12.0.9
+  class ResidencyManager
+    include Enumerable
+
+    # A tracked object.
+    class Entry < Struct.new(:object, :name, :mapped_size, :pinned)
+      alias_method :pinned?, :pinned
+    end
+
+    # @return [Integer, nil] The max total mapped size in bytes.
+    #   `nil` means no limit.
+    attr_reader :budget
+
+    # @param database [Groonga::Database] The database to be managed.
+    # @param options [::Hash]
+    # @option options [Integer, nil] :budget (nil) The max total
+    #   mapped size in bytes. `nil` means no limit.
+    def initialize(database, options={})
+      @database = database
+      @context = database.context
+      @budget = options[:budget]
+      @entries = {}
+      @pinned_names = {}
+    end
+
+    # Changes the budget. Objects are unmapped immediately if the
+    # total mapped size exceeds the new budget.
+    def budget=(budget)
+      @budget = budget
+      enforce
+    end
+
+    # Opens an object and marks it as the most recently used object.
+    #
+    # @param name [String] The name of the object.
+    # @return [Groonga::Object, nil] The object. `nil` if there is
+    #   no object for _name_.
+    def [](name)
+      object = @context[name]
+      touch(object) if object
+      object
+    end
+
+    # Marks the object as the most recently used object. Objects
+    # over the budget are unmapped.
+    #
+    # @param object [Groonga::Table, Groonga::Column] The object.
+    # @return [Groonga::Object] _object_.
+    def touch(object)
+      name = object.name
+      entry = @entries.delete(name)
+      entry ||= Entry.new(nil, name, 0, false)
+      entry.object = object
+      entry.mapped_size = object.disk_usage
+      entry.pinned = @pinned_names.key?(name)
+      @entries[name] = entry
+      enforce
+      object
+    end
+
+    # Pins the object. Pinned objects aren't unmapped by the
+    # manager. The object may not be opened yet.
+    #
+    # @param name [String, Groonga::Object] The object or its name.
+    def pin(name)
+      name = resolve_name(name)
+      @pinned_names[name] = true
+      entry = @entries[name]
+      entry.pinned = true if entry
+      nil
+    end
+
+    # Unpins the object pinned by {#pin}.
+    #
+    # @param name [String, Groonga::Object] The object or its name.
+    def unpin(name)
+      name = resolve_name(name)
+      @pinned_names.delete(name)
+      entry = @entries[name]
+      entry.pinned = false if entry
+      nil
+    end
+
+    # @param name [String, Groonga::Object] The object or its name.
+    # @return [Boolean] `true` if the object is pinned.
+    def pinned?(name)
+      @pinned_names.key?(resolve_name(name))
+    end
+
+    # @overload mapped_size
+    #   @return [Integer] The total mapped size of opened tables and
+    #     columns in the database.
+    # @overload mapped_size(name)
+    #   @param name [String, Groonga::Object] The object or its name.
+    #   @return [Integer] The mapped size of the object. It's `0`
+    #     when the object isn't mapped.
+    def mapped_size(name=nil)
+      if name.nil?
+        opened_entries.inject(0) do |total, entry|
+          total + entry.disk_usage
+        end
+      else
+        entry = @database.catalog[resolve_name(name)]
+        if entry and entry.opened?
+          entry.disk_usage
+        else
+          0
+        end
+      end
+    end
+
+    # Enumerates tracked objects from the least recently used one.
+    #
+    # @yield [entry]
+    # @yieldparam entry [Groonga::ResidencyManager::Entry]
+    def each(&block)
+      return to_enum(__method__) unless block_given?
+      @entries.values.each(&block)
+    end
+
+    # @return [Integer] The number of tracked objects.
+    def size
+      @entries.size
+    end
+
+    # Unmaps least recently used objects that aren't pinned until
+    # the total mapped size fits in the budget. It's called
+    # automatically by {#touch}. The most recently used object is
+    # never unmapped because it's being used.
+    #
+    # It lists opened objects by {Groonga::SchemaCatalog} on each
+    # call.
+    #
+    # @return [::Array<String>] The names of unmapped objects.
+    def enforce
+      return [] if @budget.nil?
+      catalog_entries = opened_entries
+      total = catalog_entries.inject(0) do |sum, catalog_entry|
+        sum + catalog_entry.disk_usage
+      end
+      return [] if total <= @budget
+
+      using_name = @entries.keys.last
+      candidates = catalog_entries.reject do |catalog_entry|
+        @entries.key?(catalog_entry.name)
+      end
+      @entries.each_key do |name|
+        catalog_entry = catalog_entries.find do |opened_entry|
+          opened_entry.name == name
+        end
+        candidates << catalog_entry if catalog_entry
+      end
+
+      unmapped_names = []
+      loop do
+        n_unmapped_names = unmapped_names.size
+        candidates.each do |catalog_entry|
+          break if total <= @budget
+          name = catalog_entry.name
+          next if name == using_name
+          next if pinned?(name)
+          next unless catalog_entries.include?(catalog_entry)
+          next if referred?(catalog_entry, catalog_entries)
+          unmap(name)
+          catalog_entries.delete(catalog_entry)
+          total -= catalog_entry.disk_usage
+          unmapped_names << name
+        end
+        break if total <= @budget
+        break if unmapped_names.size == n_unmapped_names
+      end
+      unmapped_names
+    end
+
+    # Unmaps the object by closing it. It's mapped again on the next
+    # access.
+    #
+    # Don't unmap an object that other opened objects or temporary
+    # objects refer to. They keep a pointer to it. {#enforce} never
+    # unmaps such objects.
+    #
+    # @param name [String, Groonga::Object] The object or its name.
+    def unmap(name)
+      name = resolve_name(name)
+      entry = @entries.delete(name)
+      if entry
+        object = entry.object
+      else
+        catalog_entry = @database.catalog[name]
+        return if catalog_entry.nil? or !catalog_entry.opened?
+        object = @context[name]
+      end
+      return if object.nil?
+      object.close unless object.closed?
+      nil
+    end
+
+    # Unmaps all objects in the database including pinned objects
+    # by {Groonga::Database#unmap}.
+    def unmap_all
+      @database.unmap
+      @entries.clear
+      nil
+    end
+
+    private
+    def opened_entries
+      @database.catalog.select do |entry|
+        entry.opened? and (entry.table? or entry.column?)
+      end
+    end
+
+    def referred?(catalog_entry, catalog_entries)
+      return true if @context.referred_by_temporary_object?(catalog_entry.id)
+      name = catalog_entry.name
+      catalog_entries.any? do |opened_entry|
+        next false if opened_entry.equal?(catalog_entry)
+        opened_entry.domain_name == name or opened_entry.range_name == name
+      end
+    end
+
+    def resolve_name(name)
+      if name.is_a?(Groonga::Object)
+        name.name
+      else
+        name.to_s
+      end
+    end
+  end
+end
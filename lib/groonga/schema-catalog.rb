@@ -0,0 +1,203 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "json"
+
+module Groonga
+  # It lists objects in a database without opening them.
+  #
+  # {Groonga::Database#each} opens all objects. It maps files of all
+  # tables and columns. The catalog reads metadata of objects by
+  # Groonga's `object_list` command instead. It doesn't open any
+  # objects.
+  #
+  # @example List columns of a table without opening them
+  #   catalog = database.catalog
+  #   catalog.columns("Users").each do |column|
+  #     p [column.local_name, column.range_name]
+  #   end
+  #
+  # @since 12.0.9
+  class SchemaCatalog
+    include Enumerable
+
+    # An object in the catalog.
+    class Entry < Struct.new(:id,
+                             :name,
+                             :type,
+                             :flags,
+                             :path,
+                             :domain_name,
+                             :range_name,
+                             :source_names,
+                             :opened)
+      # @return [Boolean] `true` if the object is opened in the context.
+      def opened?
+        opened
+      end
+
+      # @return [Boolean] `true` if the object is a table.
+      def table?
+        type.start_with?("table:")
+      end
+
+      # @return [Boolean] `true` if the object is a column.
+      def column?
+        type.start_with?("column:")
+      end
+
+      # @return [Boolean] `true` if the object is an index column.
+      def index_column?
+        type == "column:index"
+      end
+
+      # @return [Boolean] `true` if the object is a vector column.
+      def vector_column?
+        column? and flag?("COLUMN_VECTOR")
+      end
+
+      # @param name [String] The flag name such as `"WITH_POSITION"`.
+      # @return [Boolean] `true` if the object has the flag.
+      def flag?(name)
+        flags.include?(name)
+      end
+
+      # @return [String, nil] The table name of the column. `nil` if
+      #   the object isn't a column.
+      def table_name
+        return nil unless column?
+        name.split(".", 2)[0]
+      end
+
+      # @return [String] The column name without table name.
+      def local_name
+        return name unless column?
+        name.split(".", 2)[1]
+      end
+
+      # @return [Integer] The total size of files of the object.
+      def disk_usage
+        return 0 if path.nil?
+        Dir.glob("#{path}{,.*}").inject(0) do |total, sub_path|
+          total + File.size(sub_path)
+        end
+      end
+    end
+
+    # @param database [Groonga::Database] The database to be listed.
+    def initialize(database)
+      @database = database
+      @context = database.context
+      @entries = {}
+      load
+    end
+
+    # @param name [String] The name of the object.
+    # @return [Groonga::SchemaCatalog::Entry, nil] The entry of the
+    #   object. `nil` if there is no object for _name_.
+    def [](name)
+      @entries[name]
+    end
+
+    # Enumerates all entries in ID order.
+    #
+    # @yield [entry]
+    # @yieldparam entry [Groonga::SchemaCatalog::Entry]
+    def each(&block)
+      return to_enum(__method__) unless block_given?
+      @entries.each_value(&block)
+    end
+
+    # @return [::Array<Groonga::SchemaCatalog::Entry>] The tables
+    #   sorted by name.
+    def tables
+      @tables ||= find_all(&:table?).sort_by(&:name)
+    end
+
+    # @param table_name [String] The name of the table.
+    # @return [::Array<Groonga::SchemaCatalog::Entry>] The columns of
+    #   the table sorted by name.
+    def columns(table_name)
+      @columns ||= find_all(&:column?).sort_by(&:name).group_by(&:table_name)
+      @columns[table_name] || []
+    end
+
+    private
+    def load
+      response = @context.execute_command("object_list")
+      objects = JSON.parse(response.raw)
+      objects.each do |name, object|
+        type = object["type"]
+        next unless type.is_a?(::Hash)
+        flags = object["flags"] || {}
+        type_name = type["name"]
+        if type_name.start_with?("column:")
+          domain = object["table"]
+        else
+          domain = resolve_type(object["key"])
+        end
+        entry = Entry.new(object["id"],
+                          name,
+                          type_name,
+                          (flags["names"] || "").split("|"),
+                          object["path"],
+                          resolve_name(domain),
+                          resolve_name(resolve_type(object["value"])),
+                          resolve_source_names(object["sources"]),
+                          object["opened"])
+        @entries[name] = entry
+      end
+    end
+
+    # `object_list` reports the key type of a table as `key.type`
+    # and the value type of a table or a column as `value.type`.
+    def resolve_type(spec)
+      case spec
+      when ::Hash
+        spec["type"]
+      else
+        nil
+      end
+    end
+
+    def resolve_name(reference)
+      case reference
+      when ::Hash
+        reference["name"]
+      else
+        nil
+      end
+    end
+
+    def resolve_source_names(sources)
+      return nil unless sources.is_a?(::Array)
+      sources.collect do |source|
+        if source.is_a?(::Hash)
+          source["name"]
+        else
+          source
+        end
+      end
+    end
+  end
+
+  class Database
+    # @return [Groonga::SchemaCatalog] The catalog of the database.
+    #   It doesn't open any objects.
+    #
+    # @since 12.0.9
+    def catalog
+      SchemaCatalog.new(self)
+    end
+  end
+end
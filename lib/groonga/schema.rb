@@ -15,6 +15,7 @@
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 require 'fileutils'
+require 'json'
 
 module Groonga
 
@@ -169,6 +170,32 @@ module Groonga
         schema.define
       end
 
+      # Defines schema like {.define} but builds new indexes after
+      # all other definitions are applied. It's a shortcut of the
+      # following:
+      #
+      # <pre>
+      # !!!ruby
+      # schema = Groonga::Schema.new(options)
+      # # ...
+      # schema.migrate(migrate_options, &block)
+      # </pre>
+      #
+      # @param options [::Hash] The options for {Groonga::Schema.new}.
+      # @param migrate_options [::Hash] The options for
+      #   {Groonga::Schema#migrate}. Use `:progress` to receive the
+      #   progress because the block receives the schema.
+      # @yield [schema]
+      # @yieldparam schema [Groonga::Schema] The schema to be defined.
+      # @return [::Array<Groonga::IndexColumn>] The built index columns.
+      #
+      # @since 12.0.9
+      def migrate(options={}, migrate_options={})
+        schema = new(options)
+        yield(schema)
+        schema.migrate(migrate_options)
+      end
+
       # 名前が _name_ のテーブルを作成する。以下の省略形。
       #
       # <pre>
@@ -628,6 +655,69 @@ module Groonga
       end
     end
 
+    # Applies definitions like {#define} but builds new indexes
+    # after all tables and columns are defined.
+    #
+    # {#define} builds each index from existing records when the
+    # index is defined. {#migrate} creates index columns without
+    # sources at first. They are empty. Then it builds them grouped
+    # by their target tables. Columns of each target table are read
+    # into the page cache by {Groonga::Database#preload} once before
+    # indexes of the table are built. Each index is still built by
+    # its own scan of the target table but the scans read cached
+    # pages.
+    #
+    # If `:state_path` is specified, indexes that aren't built yet
+    # are recorded into the file. If a migration is interrupted, run
+    # the same migration again with the same `:state_path`. Index
+    # columns that are created but not built are built and an index
+    # column that was being built is rebuilt by
+    # {Groonga::IndexColumn#reindex}. The file is removed when all
+    # indexes are built.
+    #
+    # @example Add indexes to a table that has many records
+    #   Groonga::Schema.migrate({}, :state_path => "db/migration.json") do |schema|
+    #     schema.create_table("Terms",
+    #                         :type => :patricia_trie,
+    #                         :key_type => :short_text,
+    #                         :normalizer => "NormalizerAuto",
+    #                         :default_tokenizer => "TokenBigram") do |table|
+    #       table.index("Memos.title")
+    #       table.index("Memos.content")
+    #     end
+    #   end
+    #
+    # @param options [::Hash]
+    # @option options [String, nil] :state_path (nil) The path to
+    #   record indexes that aren't built yet.
+    # @option options [Boolean] :preload (true) Whether columns of
+    #   target tables are preloaded before building indexes.
+    # @option options [#call, nil] :progress (nil) It's called with
+    #   {Groonga::Schema::IndexBuilder::Progress} after each index is
+    #   built. It's used when no block is given.
+    # @yield [progress] It's called after each index is built.
+    # @yieldparam progress [Groonga::Schema::IndexBuilder::Progress]
+    # @return [::Array<Groonga::IndexColumn>] The built index columns.
+    #
+    # @since 12.0.9
+    def migrate(options={}, &block)
+      block ||= options[:progress]
+      builder = IndexBuilder.new(context, options, &block)
+      @definitions.each do |definition|
+        if definition.is_a?(TableDefinition)
+          definition.index_builder = builder
+          begin
+            definition.define
+          ensure
+            definition.index_builder = nil
+          end
+        else
+          definition.define
+        end
+      end
+      builder.build
+    end
+
     # {Groonga::Schema#dump} で返されたスキーマの内容を読み込む。
     #
     # 読み込まれた内容は {#define} を呼び出すまでは実行されない
@@ -796,11 +886,15 @@ module Groonga
       # テーブルの名前
       attr_reader :name
 
+      # @private
+      attr_accessor :index_builder
+
       # @private
       def initialize(name, options)
         @name = name
         @name = @name.to_s if @name.is_a?(Symbol)
         @definitions = []
+        @index_builder = nil
         validate_options(options)
         @options = options
         @table_type = table_type
@@ -1691,8 +1785,15 @@ module Groonga
         name = @name || self.class.column_name(context,
                                                target_table,
                                                @target_columns)
+        index_builder = table_definition.index_builder
         index = table.column(name)
         if index
+          if index_builder and deferred_index?(index_builder,
+                                               index,
+                                               target_table)
+            index_builder.add(index, target_table, @target_columns)
+            return index
+          end
           return index if same_index?(context, index, target_table)
           if @options[:force]
             index.remove
@@ -1706,13 +1807,26 @@ module Groonga
         index = table.define_index_column(name,
                                           target_table,
                                           define_options(context, table, name))
-        index.sources = @target_columns.collect do |column|
-          target_table.column(column)
+        if index_builder
+          index_builder.add(index, target_table, @target_columns)
+        else
+          index.sources = @target_columns.collect do |column|
+            target_table.column(column)
+          end
         end
         index
       end
 
       private
+      # Only index columns recorded by an interrupted migration are
+      # deferred. An index column without sources that is created by
+      # other ways is kept as is.
+      def deferred_index?(index_builder, index, target_table)
+        index_builder.pending?(index) and
+          index.range == target_table and
+          index.sources.empty?
+      end
+
       def same_index?(context, index, target_table)
         # TODO: should check column type and other options.
         range = index.range
@@ -1756,5 +1870,133 @@ module Groonga
         File.join(columns_dir, name)
       end
     end
+
+    # It builds index columns defined by {Groonga::Schema#migrate}.
+    #
+    # @since 12.0.9
+    class IndexBuilder
+      # The progress of building indexes.
+      class Progress < Struct.new(:index_name,
+                                  :n_built_indexes,
+                                  :n_indexes,
+                                  :elapsed_time)
+        # @return [Float] The ratio of built indexes in `0.0..1.0`.
+        def ratio
+          return 1.0 if n_indexes.zero?
+          n_built_indexes / n_indexes.to_f
+        end
+      end
+
+      # @private
+      Target = Struct.new(:index, :table, :column_names)
+
+      # @private
+      def initialize(context, options={}, &progress)
+        @context = context
+        @state_path = options[:state_path]
+        @preload = options.fetch(:preload, true)
+        @progress = progress
+        @targets = {}
+        @pending_index_names = load_state
+      end
+
+      # @private
+      def add(index, target_table, column_names)
+        index_name = index.name
+        @targets[index_name] = Target.new(index, target_table, column_names)
+        @pending_index_names |= [index_name]
+        save_state
+      end
+
+      # @private
+      def pending?(index)
+        @pending_index_names.include?(index.name)
+      end
+
+      # @private
+      def build
+        start_time = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+        targets = collect_targets
+        n_built_indexes = 0
+        built_indexes = []
+        targets.group_by {|target| target.table.name}.each do |_, table_targets|
+          preload(table_targets)
+          table_targets.each do |target|
+            build_index(target)
+            built_indexes << target.index
+            @pending_index_names.delete(target.index.name)
+            save_state
+            n_built_indexes += 1
+            next if @progress.nil?
+            elapsed_time =
+              Process.clock_gettime(Process::CLOCK_MONOTONIC) - start_time
+            @progress.call(Progress.new(target.index.name,
+                                        n_built_indexes,
+                                        targets.size,
+                                        elapsed_time))
+          end
+        end
+        FileUtils.rm_f(@state_path) if @state_path
+        built_indexes
+      end
+
+      private
+      def collect_targets
+        @pending_index_names.each do |index_name|
+          next if @targets.key?(index_name)
+          index = @context[index_name]
+          next if index.nil?
+          @targets[index_name] = Target.new(index, index.range, nil)
+        end
+        @targets.values.sort_by do |target|
+          [target.table.name, target.index.name]
+        end
+      end
+
+      def preload(targets)
+        return unless @preload
+        columns = []
+        targets.each do |target|
+          if target.column_names
+            target.column_names.each do |column_name|
+              next if column_name == "_key"
+              columns << target.table.column(column_name)
+            end
+          else
+            target.index.sources.each do |source|
+              columns << source if source.is_a?(Groonga::Column)
+            end
+          end
+        end
+        return if columns.empty?
+        @context.database.preload(columns.uniq, :mode => :read)
+      end
+
+      def build_index(target)
+        index = target.index
+        if target.column_names.nil?
+          # Interrupted while it was being built.
+          index.reindex
+        else
+          index.sources = target.column_names.collect do |column_name|
+            target.table.column(column_name)
+          end
+        end
+      end
+
+      def load_state
+        return [] if @state_path.nil?
+        return [] unless File.exist?(@state_path)
+        JSON.parse(File.read(@state_path))["indexes"] || []
+      end
+
+      def save_state
+        return if @state_path.nil?
+        File.open("#{@state_path}.tmp", "w") do |output|
+          output.write(JSON.generate("indexes" => @pending_index_names))
+        end
+        File.rename("#{@state_path}.tmp", @state_path)
+      end
+    end
   end
 end
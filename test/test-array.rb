@@ -157,4 +157,35 @@ class ArrayTest < Test::Unit::TestCase
     user_ids = users.each.collect(&:id)
     assert_equal([1, 2, 3], user_ids)
   end
+
+  class AddManyTest < self
+    def setup
+      super
+      @users = Groonga::Array.create(:name => "Users")
+    end
+
+    def test_contiguous
+      @users.add
+      assert_equal([2..4, 4],
+                   [@users.add_many(3), @users.size])
+    end
+
+    def test_reuse_deleted_ids
+      @users.add_many(3)
+      @users.delete(2)
+      ids = @users.add_many(2)
+      assert_equal([[2, 4], [1, 2, 3, 4]],
+                   [ids.sort, @users.collect(&:id).sort])
+    end
+
+    def test_zero
+      assert_equal([], @users.add_many(0))
+    end
+
+    def test_negative
+      assert_raise(ArgumentError) do
+        @users.add_many(-1)
+      end
+    end
+  end
 end
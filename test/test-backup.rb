@@ -0,0 +1,114 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class BackupTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  setup
+  def setup_tables
+    @users = Groonga::Hash.create(:name => "Users", :key_type => "ShortText")
+    @users.define_column("age", "UInt32")
+    @users.add("mori", :age => 46)
+    @bookmarks = Groonga::Array.create(:name => "Bookmarks")
+    @bookmarks.define_column("uri", "ShortText")
+    @bookmarks.add(:uri => "https://groonga.org/")
+    @backup_dir = @tmp_dir + "backup"
+  end
+
+  def test_full
+    report = @database.backup((@backup_dir + "full").to_s)
+    assert_equal([
+                   true,
+                   0,
+                   [],
+                 ],
+                 [
+                   report.n_copied_files > 0,
+                   report.n_linked_files,
+                   Groonga::Backup.verify((@backup_dir + "full").to_s),
+                 ])
+  end
+
+  def test_incremental
+    full_dir = (@backup_dir + "full").to_s
+    incremental_dir = (@backup_dir + "incremental").to_s
+    @database.backup(full_dir)
+    @database.close
+    @database = nil
+
+    context = Groonga::Context.new
+    begin
+      database = context.open_database(@database_path.to_s)
+      context["Users"].add("kou", :age => 31)
+      report = database.backup(incremental_dir, :incremental_from => full_dir)
+      manifest = Groonga::Backup.load_manifest(incremental_dir)
+      linked_objects = manifest["files"].reject do |file|
+        file["copied"]
+      end.collect do |file|
+        file["object"]
+      end
+      assert_equal([
+                     true,
+                     true,
+                     [],
+                   ],
+                   [
+                     report.n_linked_files > 0,
+                     linked_objects.include?("Bookmarks.uri"),
+                     Groonga::Backup.verify(incremental_dir),
+                   ])
+    ensure
+      context.close
+    end
+  end
+
+  def test_restore
+    backup_dir = (@backup_dir + "full").to_s
+    @database.backup(backup_dir)
+    restored_path = (@tmp_dir + "restored" + "db").to_s
+    Groonga::Backup.restore(backup_dir, restored_path)
+
+    context = Groonga::Context.new
+    begin
+      context.open_database(restored_path)
+      assert_equal([["mori", 46]],
+                   context["Users"].collect {|user| [user.key, user.age]})
+    ensure
+      context.close
+    end
+  end
+
+  def test_restore_with_own_path
+    Groonga::Hash.create(:name => "Tags",
+                         :key_type => "ShortText",
+                         :path => (@tmp_dir + "tags").to_s)
+    backup_dir = (@backup_dir + "full").to_s
+    @database.backup(backup_dir)
+    restored_path = (@tmp_dir + "restored" + "db").to_s
+    assert_raise(ArgumentError) do
+      Groonga::Backup.restore(backup_dir, restored_path)
+    end
+    assert_false(File.exist?(restored_path))
+  end
+
+  def test_restore_broken
+    backup_dir = (@backup_dir + "full").to_s
+    @database.backup(backup_dir)
+    File.write(File.join(backup_dir, File.basename(@users.path)), "broken")
+    assert_raise(Groonga::Backup::BrokenBackup) do
+      Groonga::Backup.restore(backup_dir, (@tmp_dir + "restored.db").to_s)
+    end
+  end
+end
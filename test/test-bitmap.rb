@@ -0,0 +1,151 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class BitmapTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  def test_new
+    bitmap = Groonga::Bitmap.new([5, 1, 3, 1])
+    assert_equal([[1, 3, 5], 3],
+                 [bitmap.to_a, bitmap.size])
+  end
+
+  def test_new_packed
+    bitmap = Groonga::Bitmap.new([3, 1, 70000].pack("L*"))
+    assert_equal([1, 3, 70000], bitmap.to_a)
+  end
+
+  def test_new_packed_invalid_size
+    assert_raise(ArgumentError) do
+      Groonga::Bitmap.new([1].pack("L") + "\0")
+    end
+  end
+
+  def test_add_delete
+    bitmap = Groonga::Bitmap.new
+    assert_equal([true, false, true, false, false],
+                 [
+                   bitmap.add(10),
+                   bitmap.add(10),
+                   bitmap.delete(10),
+                   bitmap.delete(10),
+                   bitmap.include?(10),
+                 ])
+    assert_true(bitmap.empty?)
+  end
+
+  def test_dense
+    ids = (1..10000).to_a
+    bitmap = Groonga::Bitmap.new(ids)
+    bitmap.delete(5000)
+    assert_equal([ids - [5000], 9999],
+                 [bitmap.to_a, bitmap.size])
+  end
+
+  def test_set_operations
+    evens = Groonga::Bitmap.new((2..20000).step(2).to_a)
+    threes = Groonga::Bitmap.new((3..20000).step(3).to_a + [70000])
+    assert_equal([
+                   (evens.to_a | threes.to_a).sort,
+                   evens.to_a & threes.to_a,
+                   evens.to_a - threes.to_a,
+                 ],
+                 [
+                   (evens | threes).to_a,
+                   (evens & threes).to_a,
+                   (evens - threes).to_a,
+                 ])
+  end
+
+  def test_set_operations_bang
+    bitmap = Groonga::Bitmap.new([1, 2, 3])
+    bitmap.union!(Groonga::Bitmap.new([4]))
+    bitmap.intersection!(Groonga::Bitmap.new([2, 3, 4]))
+    bitmap.difference!(Groonga::Bitmap.new([3]))
+    assert_equal(Groonga::Bitmap.new([2, 4]), bitmap)
+  end
+
+  def test_pack
+    assert_equal([1, 70000].pack("L*"),
+                 Groonga::Bitmap.new([70000, 1]).pack)
+  end
+
+  def test_dup
+    bitmap = Groonga::Bitmap.new([1])
+    copied = bitmap.dup
+    copied.add(2)
+    assert_equal([[1], [1, 2]], [bitmap.to_a, copied.to_a])
+  end
+
+  class TableTest < self
+    setup
+    def setup_users
+      @users = Groonga::Array.create(:name => "Users")
+      @users.define_column("name", "ShortText")
+      @users.define_column("age", "UInt32")
+      @users.add(:name => "mori", :age => 46)
+      @users.add(:name => "kou", :age => 31)
+      @users.add(:name => "yu", :age => 29)
+    end
+
+    def test_from_result_table
+      result = @users.select {|record| record.age < 40}
+      assert_equal([2, 3], Groonga::Bitmap.from_table(result).to_a)
+    end
+
+    def test_from_table
+      assert_equal([1, 2, 3], @users.to_bitmap.to_a)
+    end
+
+    def test_from_table_keyed_by_table
+      names = Groonga::Hash.create(:name => "Names",
+                                   :key_type => "ShortText")
+      names.add("a")
+      names.add("b")
+      aliases = Groonga::Hash.create(:name => "Aliases",
+                                     :key_type => names)
+      aliases.add(names["b"])
+      assert_equal([1], Groonga::Bitmap.from_table(aliases).to_a)
+    end
+
+    def test_to_table
+      result = Groonga::Bitmap.new([1, 3, 100]).to_table(@users)
+      assert_equal(["mori", "yu"],
+                   result.collect {|record| record.name}.sort)
+    end
+
+    def test_select_records
+      bitmap = Groonga::Bitmap.new([1, 2])
+      result = bitmap.select_records(@users) {|record| record.age < 40}
+      assert_equal(["kou"], result.collect {|record| record.name})
+    end
+
+    def test_sort_records
+      bitmap = Groonga::Bitmap.new([1, 2])
+      records = bitmap.sort_records(@users, [["age", :asc]])
+      assert_equal(["kou", "mori"], records.collect {|record| record.name})
+    end
+
+    def test_enumerable
+      bitmap = Groonga::Bitmap.new([3, 1, 2])
+      assert_equal([[1, 3], [3, 2, 1], 2],
+                   [
+                     bitmap.select(&:odd?),
+                     bitmap.sort {|a, b| b <=> a},
+                     bitmap.find(&:even?),
+                   ])
+    end
+  end
+end
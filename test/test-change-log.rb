@@ -0,0 +1,110 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class ChangeLogTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  setup
+  def setup_users
+    @users = Groonga::Hash.create(:name => "Users", :key_type => "ShortText")
+    @users.define_column("age", "UInt32")
+  end
+
+  teardown
+  def teardown_change_log
+    context.change_log = nil
+  end
+
+  def test_memory
+    change_log = Groonga::ChangeLog.new(:capacity => 2)
+    context.change_log = change_log
+    @users.add("mori", :age => 46)
+    @users.delete("mori")
+    age = context["Users.age"]
+    assert_equal([
+                   [2, :set, age.id],
+                   [3, :delete, 0],
+                 ],
+                 change_log.each(1).collect do |entry|
+                   [entry.sequence, entry.type, entry.column_id]
+                 end)
+  end
+
+  def test_memory_overwritten
+    change_log = Groonga::ChangeLog.new(:capacity => 2)
+    context.change_log = change_log
+    @users.add("mori", :age => 46)
+    @users.delete("mori")
+    assert_raise(Groonga::ChangeLog::BrokenLog) do
+      change_log.each(0).to_a
+    end
+  end
+
+  def test_temporary_table
+    change_log = Groonga::ChangeLog.new
+    @users.add("mori", :age => 46)
+    result = @users.select {|record| record.age > 20}
+    context.change_log = change_log
+    result.each do |record|
+      record.score = 10
+    end
+    assert_equal([], change_log.each.to_a)
+  end
+
+  def test_reader
+    path = (@tmp_dir + "changes.log").to_s
+    change_log = Groonga::ChangeLog.new(:path => path)
+    context.change_log = change_log
+    record = @users.add("mori")
+    context["Users.age"].increment!(record.id)
+    change_log.flush
+
+    reader = Groonga::ChangeLog::Reader.new(path)
+    entries = reader.each.collect do |entry|
+      [entry.type, entry.table_id, entry.record_id]
+    end
+    assert_equal([
+                   [
+                     [:add, @users.id, record.id],
+                     [:increment, @users.id, record.id],
+                   ],
+                   2,
+                 ],
+                 [entries, reader.sequence])
+
+    @users.delete(record.id, :id => true)
+    change_log.close
+    assert_equal([:delete],
+                 Groonga::ChangeLog::Reader.new(path, :sequence => 2).
+                   each.collect(&:type))
+  end
+
+  def test_torn_entry
+    path = (@tmp_dir + "changes.log").to_s
+    change_log = Groonga::ChangeLog.new(:path => path)
+    change_log.record(1, @users.id, 1, 0)
+    change_log.close
+    File.open(path, "ab") do |output|
+      output.write("torn")
+    end
+
+    change_log = Groonga::ChangeLog.new(:path => path)
+    change_log.record(2, @users.id, 1, 0)
+    change_log.close
+    reader = Groonga::ChangeLog::Reader.new(path)
+    assert_equal([[1, :add], [2, :delete]],
+                 reader.each.collect {|entry| [entry.sequence, entry.type]})
+  end
+end
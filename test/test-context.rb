@@ -172,6 +172,130 @@ class ContextTest < Test::Unit::TestCase
     end
   end
 
+  class DeferReleaseTest < self
+    setup :setup_database
+
+    def test_default
+      assert_false(context.defer_release?)
+    end
+
+    def test_release
+      users = Groonga::Array.create(:name => "Users")
+      users.add
+      context.defer_release = true
+      100.times do
+        users.select {|record| record.id > 0}
+      end
+      GC.start
+      n_deferred_objects = context.n_deferred_objects
+      assert_equal([true, n_deferred_objects, 0],
+                   [
+                     n_deferred_objects > 0,
+                     context.release_deferred_objects,
+                     context.n_deferred_objects,
+                   ])
+    end
+
+    def test_refetch_before_release
+      users = Groonga::Array.create(:name => "Users")
+      users.add
+      context.defer_release = true
+      column = define_result_column(users)
+      GC.start
+      result = column.table
+      context.release_deferred_objects
+      assert_equal([false, 1],
+                   [result.closed?, result.size])
+    end
+
+    def test_disable
+      context.defer_release = true
+      Groonga::Hash.create
+      GC.start
+      context.defer_release = false
+      assert_equal(0, context.n_deferred_objects)
+    end
+
+    private
+    def define_result_column(table)
+      result = table.select {|record| record.id > 0}
+      result.define_column("score", "Int32")
+    end
+  end
+
+  class RawValuesTest < self
+    setup :setup_database
+
+    setup
+    def setup_schema
+      Groonga::Schema.define do |schema|
+        schema.create_table("Users", :type => :hash, :key_type => "ShortText")
+        schema.create_table("Entries") do |table|
+          table.short_text("category")
+          table.time("created_at")
+          table.reference("author", "Users")
+          table.reference("readers", "Users", :type => :vector)
+        end
+      end
+      @entries = context["Entries"]
+      @created_at = Time.at(1, 2)
+      @entries.add(:category => "news",
+                   :created_at => @created_at,
+                   :author => "mori",
+                   :readers => ["mori", "kou"])
+      @entries.add(:category => "news")
+    end
+
+    def test_default
+      assert_equal([false, false, false],
+                   [
+                     context.raw_time?,
+                     context.interned_text?,
+                     context.raw_reference?,
+                   ])
+    end
+
+    def test_with_raw_values
+      users = context["Users"]
+      entry1 = @entries[1]
+      entry2 = @entries[2]
+      values = context.with_raw_values do
+        [
+          entry1.created_at,
+          entry1.author,
+          entry1.readers,
+          entry1.category.frozen?,
+          entry1.category.equal?(entry2.category),
+        ]
+      end
+      assert_equal([
+                     [
+                       1_000_002,
+                       users["mori"].id,
+                       [users["mori"].id, users["kou"].id],
+                       true,
+                       true,
+                     ],
+                     [@created_at, false],
+                   ],
+                   [
+                     values,
+                     [entry1.created_at, context.raw_time?],
+                   ])
+    end
+
+    def test_partial
+      context.with_raw_values(:time => false, :reference => false) do
+        assert_equal([false, true, false],
+                     [
+                       context.raw_time?,
+                       context.interned_text?,
+                       context.raw_reference?,
+                     ])
+      end
+    end
+  end
+
   class RestoreTest < self
     def test_simple
       commands = <<EOD
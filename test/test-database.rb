@@ -412,6 +412,61 @@ class DatabaseTest < Test::Unit::TestCase
     end
   end
 
+  class PreloadTest < self
+    setup :setup_database
+
+    setup
+    def setup_schema
+      Groonga::Schema.define do |schema|
+        schema.create_table("Users", :type => :hash) do |table|
+          table.short_text("name")
+        end
+        schema.create_table("Terms",
+                            :type => :patricia_trie,
+                            :key_type => "ShortText",
+                            :default_tokenizer => "TokenBigram") do |table|
+          table.index("Users.name")
+        end
+      end
+    end
+
+    def test_all
+      report = @database.preload
+      assert_equal([@database.to_a.size, true],
+                   [report.n_objects, report.n_bytes > 0])
+    end
+
+    def test_names
+      users = context["Users"]
+      report = @database.preload(["Users"], :mode => :read)
+      paths = [users.path, users.column("name").path]
+      expected_n_bytes = paths.inject(0) do |n_bytes, path|
+        Dir.glob("#{path}{,.*}").inject(n_bytes) do |sub_n_bytes, sub_path|
+          sub_n_bytes + File.size(sub_path)
+        end
+      end
+      assert_equal([2, expected_n_bytes],
+                   [report.n_objects, report.n_bytes])
+    end
+
+    def test_pattern
+      report = @database.preload(["Term*"], :mode => :open)
+      assert_equal([2, 0], [report.n_objects, report.n_bytes])
+    end
+
+    def test_nonexistent
+      assert_raise(ArgumentError) do
+        @database.preload(["Nonexistent"])
+      end
+    end
+
+    def test_invalid_mode
+      assert_raise(ArgumentError) do
+        @database.preload(:mode => :mmap)
+      end
+    end
+  end
+
   class CorruptTest < self
     setup :setup_database
 
@@ -30,4 +30,24 @@ class EncodingTest < Test::Unit::TestCase
     Groonga::Encoding.default = :utf8
     assert_equal(:utf8, Groonga::Encoding.default)
   end
+
+  class SanitizeTest < self
+    def test_valid
+      string = "森"
+      assert_same(string, Groonga::Encoding.sanitize(string))
+    end
+
+    def test_invalid
+      invalid_ranges = []
+      sanitized = Groonga::Encoding.sanitize("a\xff森\xfe\xfdb") do |*range|
+        invalid_ranges << range
+      end
+      assert_equal(["a森b", [[1, 1], [5, 1], [6, 1]]],
+                   [sanitized, invalid_ranges])
+    end
+
+    def test_truncated
+      assert_equal("a", Groonga::Encoding.sanitize("a\xe6\xa3"))
+    end
+  end
 end
@@ -911,4 +911,68 @@ EOC
                    result.collect {|record| [record["_key"], record.key.score]})
     end
   end
+
+  class OptimizeTest < self
+    def setup_tables
+      Groonga::Schema.define do |schema|
+        schema.create_table("Users",
+                            :type => :hash,
+                            :key_type => "ShortText") do |table|
+          table.short_text("name")
+          table.uint32("age")
+        end
+        schema.create_table("Terms",
+                            :type => :patricia_trie,
+                            :default_tokenizer => "TokenBigram",
+                            :normalizer => "NormalizerAuto",
+                            :key_type => "ShortText") do |table|
+          table.index("Users.name")
+        end
+      end
+
+      @users = Groonga["Users"]
+    end
+
+    def setup_data
+      @users.add("morita",      :name => "mori daijiro",     :age => 46)
+      @users.add("gunyara-kun", :name => "Tasuku SUENAGA",   :age => 35)
+      @users.add("yu",          :name => "Yutaro Shimamura", :age => 29)
+    end
+
+    def select(options={})
+      @users.select(options) do |record|
+        (record.age > 20) & (record.age < 40) & (record.name =~ "Tasuku")
+      end
+    end
+
+    def test_reorder
+      result = select(:optimize => true)
+      plan = result.expression.condition_plan
+      assert_equal([
+                     ["gunyara-kun"],
+                     [
+                       ["match(name, \"Tasuku\")", true],
+                       ["greater(age, 20)", false],
+                       ["less(age, 40)", false],
+                     ],
+                     true,
+                   ],
+                   [
+                     result.collect {|record| record.key.key},
+                     plan.children.collect do |child|
+                       [child.condition, child.indexed?]
+                     end,
+                     plan.indexed?,
+                   ])
+    end
+
+    def test_to_s
+      plan = select(:optimize => true).expression.condition_plan
+      assert_equal(4, plan.to_s.lines.size)
+    end
+
+    def test_not_optimized
+      assert_nil(select.expression.condition_plan)
+    end
+  end
 end
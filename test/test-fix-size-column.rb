@@ -214,4 +214,86 @@ class FixSizeColumnTest < Test::Unit::TestCase
       end
     end
   end
+
+  class IncrementManyTest < self
+    def setup
+      super
+      Groonga::Schema.define do |schema|
+        schema.create_table("Entries") do |table|
+          table.int32("n_clicks")
+          table.float("rate")
+        end
+      end
+      @entries = context["Entries"]
+      3.times do
+        @entries.add(:n_clicks => 10, :rate => 1.0)
+      end
+      @n_clicks = @entries.column("n_clicks")
+      @rate = @entries.column("rate")
+    end
+
+    def n_clicks
+      @entries.collect(&:n_clicks)
+    end
+
+    def test_array
+      assert_equal([2, [15, 10, 13]],
+                   [@n_clicks.increment_many!([3, 1, 3], [1, 5, 2]), n_clicks])
+    end
+
+    def test_packed
+      @n_clicks.increment_many!([2, 3].pack("L*"), [-3, 7].pack("q*"))
+      assert_equal([10, 7, 17], n_clicks)
+    end
+
+    def test_default_delta
+      @n_clicks.increment_many!([1, 1, 2])
+      assert_equal([12, 11, 10], n_clicks)
+    end
+
+    def test_float
+      @rate.increment_many!([1, 2], [0.5, -0.25])
+      assert_equal([1.5, 0.75, 1.0], @entries.collect(&:rate))
+    end
+
+    def test_deltas_size_mismatch
+      assert_raise(ArgumentError) do
+        @n_clicks.increment_many!([1, 2], [1])
+      end
+    end
+
+    def test_buffer
+      buffer = @n_clicks.increment_buffer
+      buffer.increment(1)
+      buffer.increment(@entries[3], 4)
+      buffer.decrement(1, 3)
+      before_flush = n_clicks
+      buffer.flush
+      assert_equal([[10, 10, 10], [8, 10, 14], true],
+                   [before_flush, n_clicks, buffer.empty?])
+    end
+
+    def test_buffer_max_entries
+      buffer = @n_clicks.increment_buffer(:max_entries => 2)
+      buffer.increment(1)
+      buffer.increment(2)
+      assert_equal([[11, 11, 10], 0],
+                   [n_clicks, buffer.size])
+    end
+
+    def test_buffer_lock_failed
+      buffer = @n_clicks.increment_buffer
+      buffer.increment(1)
+      @n_clicks.lock do
+        assert_raise(Groonga::ResourceDeadlockAvoided) do
+          buffer.flush
+        end
+      end
+      assert_equal([[10, 10, 10], 1],
+                   [n_clicks, buffer.size])
+      buffer.flush
+      assert_equal([[11, 10, 10], 0],
+                   [n_clicks, buffer.size])
+    end
+  end
 end
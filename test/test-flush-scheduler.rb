@@ -0,0 +1,101 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class FlushSchedulerTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  setup
+  def setup_users
+    @users = Groonga::Hash.create(:name => "Users", :key_type => "ShortText")
+    @ages = @users.define_column("age", "UInt32")
+    @scheduler = nil
+  end
+
+  teardown
+  def teardown_scheduler
+    @scheduler.stop if @scheduler
+  end
+
+  def test_group_commit
+    @scheduler = Groonga::FlushScheduler.new(@database,
+                                             :durability => :group_commit)
+    @users.add("mori", :age => 46)
+    @scheduler.commit(@users, @ages, @ages)
+    stats = @scheduler.stats
+    assert_equal([false, false, 3, 2, 0],
+                 [
+                   @users.dirty?,
+                   @ages.dirty?,
+                   stats.n_requests,
+                   stats.n_flushed_objects,
+                   stats.n_pending_objects,
+                 ])
+  end
+
+  def test_interval
+    @scheduler = Groonga::FlushScheduler.new(@database,
+                                             :durability => :interval,
+                                             :interval => 60)
+    @users.add("mori", :age => 46)
+    @scheduler.request(@users, @ages)
+    assert_equal(2, @scheduler.stats.n_pending_objects)
+    @scheduler.stop
+    assert_equal([false, 0],
+                 [@users.dirty?, @scheduler.stats.n_pending_objects])
+  end
+
+  def test_commit_after_stop
+    @scheduler = Groonga::FlushScheduler.new(@database,
+                                             :durability => :group_commit)
+    @scheduler.stop
+    assert_raise(Groonga::FlushScheduler::Stopped) do
+      @scheduler.commit(@users)
+    end
+  end
+
+  def test_commit_error
+    @scheduler = Groonga::FlushScheduler.new(@database,
+                                             :durability => :group_commit)
+    broken_object = Object.new
+    def broken_object.id
+      0
+    end
+    def broken_object.closed?
+      false
+    end
+    def broken_object.flush(options={})
+      raise "broken"
+    end
+    assert_raise(RuntimeError.new("broken")) do
+      @scheduler.commit(broken_object)
+    end
+    @users.add("mori", :age => 46)
+    @scheduler.commit(@users)
+    assert_false(@users.dirty?)
+  end
+
+  def test_none
+    @scheduler = Groonga::FlushScheduler.new(@database, :durability => :none)
+    @users.add("mori", :age => 46)
+    @scheduler.commit(@users)
+    assert_equal(0, @scheduler.stats.n_requests)
+  end
+
+  def test_invalid_durability
+    assert_raise(ArgumentError) do
+      Groonga::FlushScheduler.new(@database, :durability => :always)
+    end
+  end
+end
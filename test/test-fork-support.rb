@@ -0,0 +1,67 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class ForkSupportTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  setup
+  def setup_fork
+    omit("fork isn't supported") unless Process.respond_to?(:fork)
+    @hooks = Groonga::ForkSupport.hooks.dup
+  end
+
+  teardown
+  def teardown_hooks
+    Groonga::ForkSupport.hooks.replace(@hooks) if @hooks
+  end
+
+  def test_after_fork
+    users = Groonga::Hash.create(:name => "Users", :key_type => "ShortText")
+    users.add("mori")
+    parent_context = Groonga::Context.default
+    hook_called = false
+    Groonga.after_fork do
+      hook_called = true
+    end
+
+    input, output = IO.pipe
+    pid = fork do
+      input.close
+      Groonga.run_after_fork_hooks unless Process.respond_to?(:_fork)
+      context = Groonga::Context.default
+      result = [
+        hook_called,
+        context.equal?(parent_context),
+        context.database.path,
+        Groonga["Users"].collect(&:key),
+      ]
+      output.write(Marshal.dump(result))
+      output.close
+      exit!(0)
+    end
+    output.close
+    result = Marshal.load(input.read)
+    input.close
+    Process.waitpid(pid)
+    assert_equal([true, false, @database_path.to_s, ["mori"]],
+                 result)
+  end
+
+  def test_after_fork_without_block
+    assert_raise(ArgumentError) do
+      Groonga.after_fork
+    end
+  end
+end
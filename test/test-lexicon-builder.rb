@@ -0,0 +1,163 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class LexiconBuilderTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  def setup
+    setup_database
+  end
+
+  def test_add_keys
+    words = Groonga::PatriciaTrie.create(:name => "Words",
+                                         :key_type => "ShortText")
+    words.add("banana")
+    assert_equal(2, words.add_keys(["apple", "banana", "cherry"]))
+    assert_equal(["apple", "banana", "cherry"],
+                 words.collect(&:key).sort)
+  end
+
+  def test_add_keys_failed
+    words = Groonga::PatriciaTrie.create(:name => "Words",
+                                         :key_type => "ShortText")
+    assert_raise_kind_of(Groonga::Error) do
+      words.add_keys(["apple", "x" * 5000])
+    end
+    assert_equal(["apple"], words.collect(&:key))
+  end
+
+  def test_new_patricia_trie
+    builder = Groonga::LexiconBuilder.new("Words",
+                                          :type => :patricia_trie,
+                                          :batch_size => 2)
+    report = builder.build(["cherry", "apple", "banana", "apple"])
+    words = context["Words"]
+    assert_equal([
+                   Groonga::PatriciaTrie,
+                   ["apple", "banana", "cherry"],
+                   4,
+                   3,
+                 ],
+                 [
+                   words.class,
+                   words.collect(&:key),
+                   report.n_keys,
+                   report.n_added,
+                 ])
+  end
+
+  def test_new_double_array_trie
+    builder = Groonga::LexiconBuilder.new("Words",
+                                          :type => :double_array_trie,
+                                          :sorted => true)
+    builder.build(["apple", "banana"].each)
+    words = context["Words"]
+    assert_equal([Groonga::DoubleArrayTrie, ["apple", "banana"]],
+                 [words.class, words.collect(&:key)])
+  end
+
+  def test_replace
+    Groonga::Schema.define do |schema|
+      schema.create_table("Memos") do |table|
+        table.text("content")
+      end
+      schema.create_table("Terms",
+                          :type => :patricia_trie,
+                          :key_type => "ShortText",
+                          :default_tokenizer => "TokenBigram",
+                          :normalizer => "NormalizerAuto") do |table|
+        table.index("Memos.content")
+      end
+    end
+    memos = context["Memos"]
+    memos.add(:content => "Groonga is fast")
+
+    builder = Groonga::LexiconBuilder.new("Terms")
+    builder.build(["rroonga", "groonga"])
+    terms = context["Terms"]
+    assert_equal([
+                   Groonga::PatriciaTrie,
+                   "TokenBigram",
+                   "NormalizerAuto",
+                   [memos.column("content")],
+                   nil,
+                   nil,
+                 ],
+                 [
+                   terms.class,
+                   terms.default_tokenizer.name,
+                   terms.normalizer.name,
+                   terms.column("content").sources,
+                   context["Terms_building"],
+                   context["Terms_replaced"],
+                 ])
+    result = memos.select do |record|
+      record.content =~ "fast"
+    end
+    assert_equal(["Groonga is fast"],
+                 result.collect {|record| record.content})
+  end
+
+  def test_replace_with_data_column
+    Groonga::Schema.define do |schema|
+      schema.create_table("Words",
+                          :type => :patricia_trie,
+                          :key_type => "ShortText") do |table|
+        table.uint32("count")
+      end
+    end
+    builder = Groonga::LexiconBuilder.new("Words")
+    assert_raise(ArgumentError) do
+      builder.build(["apple"])
+    end
+  end
+
+  def test_replace_with_reference_column
+    Groonga::Schema.define do |schema|
+      schema.create_table("Words",
+                          :type => :patricia_trie,
+                          :key_type => "ShortText")
+      schema.create_table("Memos") do |table|
+        table.reference("word", "Words")
+      end
+    end
+    builder = Groonga::LexiconBuilder.new("Words")
+    assert_raise(ArgumentError) do
+      builder.build(["apple"])
+    end
+    assert_equal(["Words", nil, nil],
+                 [
+                   context["Memos.word"].range.name,
+                   context["Words_building"],
+                   context["Words_replaced"],
+                 ])
+  end
+
+  def test_path
+    path = @tmp_dir + "words.txt"
+    path.open("w") do |file|
+      file.puts("banana")
+      file.puts("apple")
+      file.puts("")
+    end
+    builder = Groonga::LexiconBuilder.new("Words")
+    report = builder.build(path)
+    assert_equal([["apple", "banana"], 2],
+                 [context["Words"].collect(&:key), report.n_keys])
+  end
+
+  def test_keys_per_second
+    report = Groonga::LexiconBuilder::Report.new(10, 10, 2.0)
+    assert_equal(5.0, report.keys_per_second)
+  end
+end
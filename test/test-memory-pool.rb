@@ -85,4 +85,33 @@ class MemoryPoolTest < Test::Unit::TestCase
     end
     assert_true(adults.closed?)
   end
+
+  def test_closed_in_pool
+    adults = nil
+    context.push_memory_pool do
+      adults = @users.select do |user|
+        user.age >= 20
+      end
+      adults.close
+    end
+    assert_true(adults.closed?)
+  end
+
+  def test_gc_in_pool
+    n_records = nil
+    context.push_memory_pool do
+      adults = @users.select do |user|
+        user.age >= 20
+      end
+      GC.start
+      n_records = adults.size
+    end
+    assert_equal(3, n_records)
+  end
+
+  def test_pop_without_push
+    assert_raise(Groonga::Error) do
+      context.pop_memory_pool
+    end
+  end
 end
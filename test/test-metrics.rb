@@ -0,0 +1,99 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class MetricsTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  def setup
+    setup_database
+    setup_schema
+    Groonga::Metrics.reset
+    context.reset_metrics
+    Groonga::Metrics.enable
+  end
+
+  def teardown
+    Groonga::Metrics.disable
+    Groonga::Metrics.reset
+  end
+
+  def setup_schema
+    Groonga::Schema.define do |schema|
+      schema.create_table("Users",
+                          :type => :hash,
+                          :key_type => :short_text) do |table|
+        table.uint8(:age)
+      end
+    end
+    @users = context["Users"]
+  end
+
+  def n_calls(metrics)
+    [
+      metrics[:add][:n_calls],
+      metrics[:column_write][:n_calls],
+      metrics[:select][:n_calls],
+      metrics[:sort][:n_calls],
+    ]
+  end
+
+  def run_operations
+    @users.add("mori", :age => 46)
+    @users.add("kou", :age => 31)
+    result = @users.select {|record| record.age > 30}
+    result.sort(["age"])
+  end
+
+  def test_snapshot
+    run_operations
+    assert_equal([2, 2, 1, 1],
+                 n_calls(Groonga::Metrics.snapshot))
+  end
+
+  def test_context
+    run_operations
+    assert_equal([2, 2, 1, 1],
+                 n_calls(context.metrics))
+  end
+
+  def test_histogram
+    run_operations
+    select = Groonga::Metrics.snapshot[:select]
+    n_bucket_calls = select[:buckets].inject(0) do |sum, (_, n)|
+      sum + n
+    end
+    assert_equal([1, true, true],
+                 [
+                   n_bucket_calls,
+                   select[:min_time] <= select[:p50],
+                   select[:p50] <= select[:max_time],
+                 ])
+  end
+
+  def test_reset
+    run_operations
+    Groonga::Metrics.reset
+    assert_equal([0, 0, 0, 0],
+                 n_calls(Groonga::Metrics.snapshot))
+  end
+
+  def test_disable
+    Groonga::Metrics.disable
+    run_operations
+    assert_equal([false, [0, 0, 0, 0]],
+                 [
+                   Groonga::Metrics.enabled?,
+                   n_calls(Groonga::Metrics.snapshot),
+                 ])
+  end
+end
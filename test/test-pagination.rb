@@ -223,6 +223,71 @@ class PaginationTest < Test::Unit::TestCase
                     :size => 50)
   end
 
+  class AfterTest < self
+    def keys(records)
+      records.collect {|record| record.value.key}
+    end
+
+    def test_next_cursor
+      users = @users.paginate([["number", :desc]], :size => 3)
+      assert_equal([148], users.next_cursor)
+    end
+
+    def test_after
+      sort_keys = [["number", :desc]]
+      first_page = @users.paginate(sort_keys, :size => 3)
+      second_page = @users.paginate(sort_keys,
+                                    :size => 3,
+                                    :after => first_page.next_cursor)
+      assert_equal([
+                     ["user147", "user146", "user145"],
+                     3,
+                     150,
+                     true,
+                     [145],
+                   ],
+                   [
+                     keys(second_page),
+                     second_page.page_size,
+                     second_page.n_records,
+                     second_page.have_next_page?,
+                     second_page.next_cursor,
+                   ])
+    end
+
+    def test_tie_breaker
+      @users.add("user151", :number => 1)
+      sort_keys = [["number", :asc], ["_id", :asc]]
+      users = @users.paginate(sort_keys, :size => 1)
+      users = @users.paginate(sort_keys,
+                              :size => 1,
+                              :after => users.next_cursor)
+      assert_equal(["user151"], keys(users))
+    end
+
+    def test_last_page
+      users = @users.paginate([["number"]],
+                              :size => 10,
+                              :after => [145])
+      assert_equal([
+                     ["user146", "user147", "user148", "user149", "user150"],
+                     false,
+                     nil,
+                   ],
+                   [
+                     keys(users),
+                     users.have_next_page?,
+                     users.next_cursor,
+                   ])
+    end
+
+    def test_wrong_cursor_size
+      assert_raise(ArgumentError) do
+        @users.paginate([["number"]], :after => [1, 2])
+      end
+    end
+  end
+
   private
   def assert_paginate(expected, options={})
     users = @users.paginate([["number"]], options)
@@ -0,0 +1,109 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class QueryCacheTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  def setup
+    setup_database
+    setup_schema
+    setup_data
+    @cache = Groonga::QueryCache.new
+  end
+
+  def setup_schema
+    Groonga::Schema.define do |schema|
+      schema.create_table("Users",
+                          :type => :hash,
+                          :key_type => :short_text) do |table|
+        table.uint8(:age)
+        table.short_text(:hobby)
+      end
+    end
+    @users = context["Users"]
+  end
+
+  def setup_data
+    @users.add("mori",   :age => 46, :hobby => "violin")
+    @users.add("s-yata", :age => 28, :hobby => "programming")
+    @users.add("kou",    :age => 31, :hobby => "programming")
+
+    past = Time.now - 60
+    @users.touch(past)
+    @users.columns.each do |column|
+      column.touch(past)
+    end
+  end
+
+  def select_adults
+    @cache.select(@users, :sort_keys => [["age", :desc]]) do |user|
+      user.age >= 30
+    end
+  end
+
+  def test_miss_and_hit
+    first = select_adults
+    second = select_adults
+    assert_equal([
+                   ["mori", "kou"],
+                   ["mori", "kou"],
+                   [1, 1],
+                 ],
+                 [
+                   first.collect(&:key),
+                   second.collect(&:key),
+                   [@cache.statistics.n_misses, @cache.statistics.n_hits],
+                 ])
+  end
+
+  def test_query_string
+    result = @cache.select(@users, "hobby:programming",
+                           :sort_keys => ["age"])
+    assert_equal([["s-yata", "kou"], 2],
+                 [result.collect(&:key), result.n_hits])
+  end
+
+  def test_offset_and_limit
+    result = @cache.select(@users,
+                           :sort_keys => [["age", :desc]],
+                           :offset => 1,
+                           :limit => 1)
+    assert_equal([["kou"], 3],
+                 [result.collect(&:key), result.n_hits])
+  end
+
+  def test_expire_by_change
+    select_adults
+    @users.add("yata", :age => 40, :hobby => "programming")
+    result = select_adults
+    assert_equal([["mori", "yata", "kou"], 1],
+                 [result.collect(&:key), @cache.statistics.n_expired])
+  end
+
+  def test_evict
+    cache = Groonga::QueryCache.new(:max_bytes => 300)
+    cache.select(@users, "hobby:programming")
+    cache.select(@users, "hobby:violin")
+    statistics = cache.statistics
+    assert_equal([1, 1],
+                 [statistics.n_entries, statistics.n_evicted])
+  end
+
+  def test_hit_rate
+    select_adults
+    select_adults
+    select_adults
+    select_adults
+    assert_equal(0.75, @cache.statistics.hit_rate)
+  end
+end
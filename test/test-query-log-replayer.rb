@@ -0,0 +1,116 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "stringio"
+
+require "groonga/query-log-replayer"
+
+class QueryLogReplayerTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  def setup
+    setup_database
+    Groonga::Schema.define do |schema|
+      schema.create_table("Users",
+                          :type => :hash,
+                          :key_type => :short_text) do |table|
+        table.uint8(:age)
+      end
+    end
+    users = context["Users"]
+    users.add("mori", :age => 46)
+    users.add("kou", :age => 31)
+  end
+
+  def parse(log)
+    Groonga::QueryLogReplayer::Parser.new.parse(StringIO.new(log))
+  end
+
+  class ParserTest < self
+    def test_query_log
+      log = <<-LOG
+2024-01-01 00:00:00.000000|0x1|>select Users --filter 'age > 40'
+2024-01-01 00:00:00.250000|0x2|>status
+2024-01-01 00:00:00.500000|0x1|:000000000100000 filter(1)
+2024-01-01 00:00:00.500000|0x1|<000000500000000 rc=0
+      LOG
+      requests = parse(log)
+      assert_equal([
+                     ["select Users --filter 'age > 40'", 0.0, 0.5],
+                     ["status", 0.25, nil],
+                   ],
+                   requests.collect(&:to_a))
+    end
+
+    def test_empty
+      assert_equal([], parse(""))
+    end
+  end
+
+  class ReplayTest < self
+    def requests
+      parse(<<-LOG)
+2024-01-01 00:00:00.000000|0x1|>select Users --filter 'age > 40'
+2024-01-01 00:00:00.010000|0x2|>/d/select?table=Users&filter=age%3C40
+2024-01-01 00:00:00.020000|0x3|>nonexistent
+      LOG
+    end
+
+    def test_thread
+      replayer = Groonga::QueryLogReplayer.new(@database_path.to_s,
+                                               :n_workers => 2)
+      report = replayer.replay(requests)
+      assert_equal([3, 1],
+                   [report.n_requests, report.n_errors])
+    end
+
+    def test_preserve_timing
+      replayer = Groonga::QueryLogReplayer.new(@database_path.to_s,
+                                               :preserve_timing => true)
+      report = replayer.replay(requests)
+      assert_operator(report.elapsed_time, :>=, 0.02)
+    end
+
+    def test_process
+      omit("fork isn't available") unless Process.respond_to?(:fork)
+      replayer = Groonga::QueryLogReplayer.new(@database_path.to_s,
+                                               :n_workers => 2,
+                                               :mode => :process)
+      report = replayer.replay(requests)
+      assert_equal(3, report.n_requests)
+    end
+  end
+
+  class DumpPlanTest < self
+    def dump_plan(command)
+      replayer = Groonga::QueryLogReplayer.new(@database_path.to_s)
+      replayer.dump_plan(command, context)
+    end
+
+    def test_command_line
+      assert_not_nil(dump_plan("select Users --filter 'age > 40'"))
+    end
+
+    def test_uri
+      assert_not_nil(dump_plan("/d/select?table=Users&filter=age%3E40"))
+    end
+
+    def test_no_condition
+      assert_nil(dump_plan("select Users"))
+    end
+
+    def test_not_select
+      assert_nil(dump_plan("status"))
+    end
+  end
+end
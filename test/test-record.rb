@@ -688,4 +688,66 @@ class RecordTest < Test::Unit::TestCase
       assert_equal(expected, groonga.to_json)
     end
   end
+
+  class IdentityMapTest < self
+    def test_reference
+      @users.add("morita")
+      @bookmarks.add(:uri => "http://groonga.org/", :user => "morita")
+      @bookmarks.add(:uri => "http://ranguba.org/", :user => "morita")
+      context.with_record_identity_map do
+        users = @bookmarks.collect(&:user)
+        assert_same(users[0], users[1])
+        assert_same(users[0], @users["morita"])
+      end
+    end
+
+    def test_restore
+      @users.add("morita")
+      context.with_record_identity_map do
+      end
+      assert_nil(context.record_identity_map)
+      assert_not_same(@users["morita"], @users["morita"])
+    end
+
+    def test_added
+      context.with_record_identity_map do
+        morita = @users.add("morita")
+        assert_equal([true, false],
+                     [morita.added?, @users["morita"].added?])
+      end
+    end
+  end
+
+  class FlyweightTest < self
+    def test_table_each
+      @bookmarks.add(:uri => "http://groonga.org/")
+      @bookmarks.add(:uri => "http://ranguba.org/")
+      records = []
+      uris = []
+      @bookmarks.each(:flyweight => true) do |record|
+        records << record
+        uris << record.uri
+      end
+      assert_equal([
+                     ["http://groonga.org/", "http://ranguba.org/"],
+                     1,
+                   ],
+                   [uris, records.uniq(&:object_id).size])
+    end
+
+    def test_table_cursor_each
+      @users.add("morita")
+      @users.add("yu")
+      records = []
+      keys = []
+      @users.open_cursor(:order_by => :id) do |cursor|
+        cursor.each(:flyweight => true) do |record|
+          records << record
+          keys << record.key
+        end
+      end
+      assert_equal([["morita", "yu"], 1],
+                   [keys, records.uniq(&:object_id).size])
+    end
+  end
 end
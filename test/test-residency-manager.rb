@@ -0,0 +1,129 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class ResidencyManagerTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  setup
+  def setup_schema
+    Groonga::Schema.define do |schema|
+      schema.create_table("Users", :type => :hash)
+      schema.create_table("Bookmarks", :type => :hash)
+      schema.create_table("Tags", :type => :hash)
+    end
+    @database.unmap
+  end
+
+  def test_mapped_size
+    manager = Groonga::ResidencyManager.new(@database)
+    users = manager["Users"]
+    assert_equal([users.disk_usage, users.disk_usage, 0],
+                 [
+                   manager.mapped_size,
+                   manager.mapped_size("Users"),
+                   manager.mapped_size("Tags"),
+                 ])
+  end
+
+  def test_budget
+    size = context["Users"].disk_usage
+    manager = Groonga::ResidencyManager.new(@database, :budget => size * 2)
+    users = manager["Users"]
+    manager["Bookmarks"]
+    manager["Tags"]
+    assert_equal([["Bookmarks", "Tags"], true],
+                 [manager.collect(&:name), users.closed?])
+  end
+
+  def test_touch
+    size = context["Users"].disk_usage
+    manager = Groonga::ResidencyManager.new(@database, :budget => size * 2)
+    manager["Users"]
+    manager["Bookmarks"]
+    manager["Users"]
+    manager["Tags"]
+    assert_equal(["Users", "Tags"], manager.collect(&:name))
+  end
+
+  def test_pin
+    size = context["Users"].disk_usage
+    manager = Groonga::ResidencyManager.new(@database, :budget => size)
+    manager.pin("Users")
+    manager["Users"]
+    manager["Bookmarks"]
+    manager["Tags"]
+    assert_equal([["Users", "Tags"], [true, false]],
+                 [manager.collect(&:name), manager.collect(&:pinned?)])
+  end
+
+  def test_objects_opened_outside
+    size = @database.catalog["Users"].disk_usage
+    manager = Groonga::ResidencyManager.new(@database, :budget => size)
+    context["Tags"]
+    assert_equal(size, manager.mapped_size)
+    manager["Users"]
+    catalog = @database.catalog
+    assert_equal([false, true],
+                 [catalog["Tags"].opened?, catalog["Users"].opened?])
+  end
+
+  def test_referred_by_column
+    Groonga::Schema.define do |schema|
+      schema.create_table("Comments", :type => :hash) do |table|
+        table.reference("user", "Users")
+      end
+    end
+    @database.unmap
+    size = @database.catalog["Users"].disk_usage
+    manager = Groonga::ResidencyManager.new(@database, :budget => size)
+    users = manager["Users"]
+    user = manager["Comments.user"]
+    assert_equal([[], false, false],
+                 [manager.enforce, users.closed?, user.closed?])
+  end
+
+  def test_referred_by_temporary_object
+    size = @database.catalog["Users"].disk_usage
+    manager = Groonga::ResidencyManager.new(@database, :budget => size)
+    users = manager["Users"]
+    result = users.select
+    manager["Tags"]
+    assert_equal([false, false], [users.closed?, result.closed?])
+  end
+
+  def test_reopen
+    manager = Groonga::ResidencyManager.new(@database)
+    users = manager["Users"]
+    manager.unmap("Users")
+    assert_equal([true, false],
+                 [users.closed?, manager["Users"].closed?])
+  end
+
+  def test_inspector
+    manager = Groonga::ResidencyManager.new(@database)
+    manager.pin("Users")
+    manager["Users"]
+    options = Groonga::DatabaseInspector::Options.new
+    options.residency_manager = manager
+    output = StringIO.new
+    Groonga::DatabaseInspector.new(@database, options).report(output)
+    assert_equal([
+                   "  Residency:\n",
+                   "    N objects:   1\n",
+                   "    N pinned:    1\n",
+                 ],
+                 output.string.lines.grep(/Residency|N objects|N pinned/))
+  end
+end
@@ -0,0 +1,109 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+class SchemaCatalogTest < Test::Unit::TestCase
+  include GroongaTestUtils
+
+  setup :setup_database
+
+  setup
+  def setup_schema
+    Groonga::Schema.define do |schema|
+      schema.create_table("Users", :type => :hash) do |table|
+        table.short_text("name")
+        table.short_text("tags", :type => :vector)
+      end
+      schema.create_table("Bookmarks", :type => :hash) do |table|
+        table.reference("user", "Users")
+      end
+      schema.create_table("Terms",
+                          :type => :patricia_trie,
+                          :key_type => "ShortText",
+                          :default_tokenizer => "TokenBigram") do |table|
+        table.index("Users.name")
+      end
+    end
+  end
+
+  def test_tables
+    catalog = @database.catalog
+    assert_equal([
+                   ["Bookmarks", "Terms", "Users"],
+                   ["table:hash_key", "table:pat_key", "table:hash_key"],
+                 ],
+                 [catalog.tables.collect(&:name),
+                  catalog.tables.collect(&:type)])
+  end
+
+  def test_columns
+    columns = @database.catalog.columns("Users")
+    assert_equal([
+                   ["name", "tags"],
+                   ["Users", "Users"],
+                   [false, true],
+                   [context["Users.name"].id, context["Users.tags"].id],
+                 ],
+                 [
+                   columns.collect(&:local_name),
+                   columns.collect(&:table_name),
+                   columns.collect(&:vector_column?),
+                   columns.collect(&:id),
+                 ])
+  end
+
+  def test_index_column
+    entry = @database.catalog["Terms.Users_name"]
+    assert_equal([true, true, "Terms", "Users", ["Users.name"]],
+                 [
+                   entry.index_column?,
+                   entry.flag?("WITH_POSITION"),
+                   entry.domain_name,
+                   entry.range_name,
+                   entry.source_names,
+                 ])
+  end
+
+  def test_scalar_column_range
+    entry = @database.catalog["Users.name"]
+    assert_equal(["Users", "ShortText"],
+                 [entry.domain_name, entry.range_name])
+  end
+
+  def test_reference_column_range
+    entry = @database.catalog["Bookmarks.user"]
+    assert_equal(["Bookmarks", "Users"],
+                 [entry.domain_name, entry.range_name])
+  end
+
+  def test_table_key_type
+    entry = @database.catalog["Terms"]
+    assert_equal("ShortText", entry.domain_name)
+  end
+
+  def test_disk_usage
+    users = context["Users"]
+    assert_equal(users.disk_usage,
+                 @database.catalog["Users"].disk_usage)
+  end
+
+  def test_not_open
+    other_context = Groonga::Context.new
+    other_context.open_database(@database_path.to_s) do |database|
+      catalog = database.catalog
+      column_ids = catalog.columns("Users").collect(&:id)
+      assert_equal([false, false],
+                   column_ids.collect {|id| other_context.opened?(id)})
+    end
+    other_context.close
+  end
+end
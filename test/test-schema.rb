@@ -849,6 +849,112 @@ class SchemaTest < Test::Unit::TestCase
     assert_equal(short_text, Groonga["Users"].domain)
   end
 
+  class MigrateTest < self
+    setup
+    def setup_memos
+      Groonga::Schema.create_table("Memos") do |table|
+        table.short_text("title")
+        table.text("content")
+      end
+      memos = context["Memos"]
+      memos.add(:title => "Groonga", :content => "Fast search engine")
+      memos.add(:title => "Rroonga", :content => "Ruby bindings")
+    end
+
+    def test_build
+      built_indexes = Groonga::Schema.migrate do |schema|
+        schema.create_table("Terms",
+                            :type => :patricia_trie,
+                            :key_type => :short_text,
+                            :normalizer => "NormalizerAuto",
+                            :default_tokenizer => "TokenBigram") do |table|
+          table.index("Memos.title")
+          table.index("Memos.content")
+        end
+      end
+      assert_equal([
+                     ["Terms.Memos_content", "Terms.Memos_title"],
+                     [context["Memos.content"]],
+                     ["Rroonga"],
+                   ],
+                   [
+                     built_indexes.collect(&:name),
+                     context["Terms.Memos_content"].sources,
+                     context["Memos"].select {|record| record.title =~ "Rroonga"}.
+                       collect {|record| record.title},
+                   ])
+    end
+
+    def test_progress
+      progresses = []
+      schema = Groonga::Schema.new
+      schema.create_table("Terms",
+                          :type => :patricia_trie,
+                          :key_type => :short_text,
+                          :default_tokenizer => "TokenBigram") do |table|
+        table.index("Memos.title")
+        table.index("Memos.content")
+      end
+      schema.migrate do |progress|
+        progresses << [progress.index_name, progress.ratio]
+      end
+      assert_equal([
+                     ["Terms.Memos_content", 0.5],
+                     ["Terms.Memos_title", 1.0],
+                   ],
+                   progresses)
+    end
+
+    def test_progress_option
+      progresses = []
+      progress = lambda do |current_progress|
+        progresses << [current_progress.index_name, current_progress.ratio]
+      end
+      Groonga::Schema.migrate({}, :progress => progress) do |schema|
+        schema.create_table("Terms",
+                            :type => :patricia_trie,
+                            :key_type => :short_text,
+                            :default_tokenizer => "TokenBigram") do |table|
+          table.index("Memos.title")
+        end
+      end
+      assert_equal([["Terms.Memos_title", 1.0]], progresses)
+    end
+
+    def test_resume
+      state_path = (@tmp_dir + "migration.json").to_s
+      Groonga::Schema.create_table("Terms",
+                                   :type => :patricia_trie,
+                                   :key_type => :short_text,
+                                   :default_tokenizer => "TokenBigram") do |table|
+        table.index("Memos.title")
+      end
+      index = context["Terms.Memos_title"]
+      File.write(state_path, JSON.generate("indexes" => [index.name]))
+      schema = Groonga::Schema.new
+      schema.change_table("Terms") do |table|
+        table.index("Memos.title")
+      end
+      built_indexes = schema.migrate(:state_path => state_path)
+      assert_equal([[index.name], false],
+                   [built_indexes.collect(&:name), File.exist?(state_path)])
+    end
+
+    def test_existing_index_without_sources
+      terms = Groonga::PatriciaTrie.create(:name => "Terms",
+                                           :key_type => "ShortText",
+                                           :default_tokenizer => "TokenBigram")
+      terms.define_index_column("Memos_title", context["Memos"])
+      schema = Groonga::Schema.new
+      schema.change_table("Terms") do |table|
+        table.index("Memos.title")
+      end
+      assert_raise(Groonga::Schema::ColumnCreationWithDifferentOptions) do
+        schema.migrate
+      end
+    end
+  end
+
   class RemoveTest < self
     def test_tables_directory_removed_on_last_table_remove
       table_name = "Posts"
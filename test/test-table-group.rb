@@ -365,4 +365,64 @@ class TableGroupTest < Test::Unit::TestCase
                    grouped_data)
     end
   end
+
+  class DrilldownTest < self
+    setup
+    def setup_schema
+      Groonga::Schema.define do |schema|
+        schema.create_table("Memos", :type => :array) do |table|
+          table.short_text("category")
+          table.int32("priority")
+        end
+      end
+    end
+
+    setup
+    def setup_data
+      @memos = Groonga["Memos"]
+      @memos.add(:category => "Groonga", :priority => 10)
+      @memos.add(:category => "Rroonga", :priority => 10)
+      @memos.add(:category => "Groonga", :priority => 20)
+      @memos.add(:category => "Mroonga", :priority => 10)
+      @memos.add(:category => "Groonga", :priority => 20)
+    end
+
+    def test_tables
+      facets = @memos.drilldown(["category", "priority"])
+      grouped_data = facets.collect do |key, records|
+        data = records.collect do |record|
+          [record.key, record.n_sub_records]
+        end
+        [key, data.sort]
+      end
+      assert_equal([
+                     ["category", [["Groonga", 3], ["Mroonga", 1], ["Rroonga", 1]]],
+                     ["priority", [[10, 3], [20, 2]]],
+                   ],
+                   grouped_data)
+    end
+
+    def test_column
+      column = @memos.column("priority")
+      facets = @memos.drilldown([column], :packed => true)
+      assert_equal({column => [[10, 20], [3, 2]]}, facets)
+    end
+
+    def test_packed
+      facets = @memos.drilldown(["category", "priority"],
+                                :packed => true,
+                                :limit => 2)
+      assert_equal({
+                     "category" => [["Groonga", "Mroonga"], [3, 1]],
+                     "priority" => [[10, 20], [3, 2]],
+                   },
+                   facets)
+    end
+
+    def test_unknown_key
+      assert_raise(ArgumentError) do
+        @memos.drilldown(["nonexistent"])
+      end
+    end
+  end
 end
@@ -486,4 +486,93 @@ class VariableSizeColumnTest < Test::Unit::TestCase
       end
     end
   end
+
+  class PackedTest < self
+    def setup_schema
+      Groonga::Schema.define do |schema|
+        schema.create_table("Tags",
+                            :type => :patricia_trie,
+                            :key_type => :short_text) do |table|
+        end
+        schema.create_table("Products",
+                            :type => :patricia_trie,
+                            :key_type => :short_text) do |table|
+          table.short_text("name")
+          table.int32("scores", :type => :vector)
+          table.short_text("labels",
+                           :type => :vector,
+                           :with_weight => true)
+          table.reference("tags", "Tags",
+                          :type => :vector,
+                          :with_weight => true)
+        end
+      end
+
+      @products = Groonga["Products"]
+      @tags = Groonga["Tags"]
+      @groonga = @products.add("Groonga")
+    end
+
+    def test_fix_size
+      scores = @products.column("scores")
+      scores.write_packed(@groonga.id, [1, -2, 3].pack("l*"))
+      values, weights = scores.read_packed(@groonga.id)
+      assert_equal([[1, -2, 3], nil, [1, -2, 3]],
+                   [values.unpack("l*"), weights, @groonga.scores])
+    end
+
+    def test_text
+      labels = @products.column("labels")
+      labels.write_packed(@groonga.id,
+                          ["search", "engine"],
+                          [10, 2].pack("f*"))
+      values, weights = labels.read_packed(@groonga.id)
+      assert_equal([["search", "engine"], [10.0, 2.0]],
+                   [values, weights.unpack("f*")])
+    end
+
+    def test_text_convertible
+      label = Object.new
+      def label.to_str
+        "search"
+      end
+      labels = @products.column("labels")
+      values = [label, "engine"]
+      labels.write_packed(@groonga.id, values)
+      assert_equal([["search", "engine"], label],
+                   [labels.read_packed(@groonga.id)[0], values[0]])
+    end
+
+    def test_reference
+      groonga_tag = @tags.add("groonga")
+      search_tag = @tags.add("full text search")
+      tags = @products.column("tags")
+      tags.write_packed(@groonga.id,
+                        [groonga_tag.id, search_tag.id].pack("L*"),
+                        [100, 1000].pack("f*"))
+      ids, weights = tags.read_packed(@groonga.id)
+      assert_equal([
+                     [groonga_tag.id, search_tag.id],
+                     [100.0, 1000.0],
+                     [
+                       {:value => groonga_tag, :weight => 100},
+                       {:value => search_tag, :weight => 1000},
+                     ],
+                   ],
+                   [ids.unpack("L*"), weights.unpack("f*"), @groonga.tags])
+    end
+
+    def test_weights_size_mismatch
+      tags = @products.column("tags")
+      assert_raise(ArgumentError) do
+        tags.write_packed(@groonga.id, [1, 2].pack("L*"), [1].pack("f*"))
+      end
+    end
+
+    def test_not_vector
+      assert_raise(ArgumentError) do
+        @products.column("name").read_packed(@groonga.id)
+      end
+    end
+  end
 end